@@ -0,0 +1,207 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include <glib.h>
+#include <vconf.h>
+
+#include <tcore.h>
+#include <server.h>
+#include <plugin.h>
+#include <storage.h>
+
+#include "vconf-schema.h"
+#include "vconf-storage.h"
+#include "vconf-fake.h"
+#include "tcore-fake.h"
+#include "bench.h"
+
+extern struct tcore_plugin_define_desc plugin_define_desc;
+
+static const struct vconf_schema_entry schema[] = {
+	VCONF_SCHEMA(VCONF_SCHEMA_ENTRY)
+};
+
+gint64 bench_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (gint64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+long bench_peak_rss(void)
+{
+	struct rusage ru;
+
+	if (getrusage(RUSAGE_SELF, &ru) != 0)
+		return -1;
+
+	return ru.ru_maxrss;
+}
+
+/* what tel-vconf-provision creates at install time */
+static void provision(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < G_N_ELEMENTS(schema); i++) {
+		switch (schema[i].type) {
+			case VCONF_TYPE_INT:
+				vconf_set_int(schema[i].name, schema[i].ival);
+				break;
+			case VCONF_TYPE_BOOL:
+				vconf_set_bool(schema[i].name, schema[i].ival);
+				break;
+			case VCONF_TYPE_STRING:
+				vconf_set_str(schema[i].name, schema[i].sval);
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+void bench_env_settle(void)
+{
+	do {
+		vconf_storage_flush();
+		while (g_main_context_iteration(NULL, FALSE))
+			;
+	} while (g_main_context_pending(NULL));
+}
+
+struct measurement {
+	double call_ns;			/* in func */
+	double settle_ns;		/* in the main loop work it queued */
+	double allocs;
+	double writes;
+};
+
+/* idle baseline of the running environment, see bench_run() */
+static gboolean calibrated;
+static struct measurement base;
+
+void bench_env_start(struct bench_env *env, const char *conf)
+{
+	if (!g_file_set_contents(VCONF_PLUGIN_CONF, conf ? conf : "", -1, NULL))
+		g_error("failed to write %s", VCONF_PLUGIN_CONF);
+
+	vconf_fake_reset();
+	provision();
+
+	env->server = tcore_server_new();
+	env->modem = tcore_plugin_new(env->server, NULL, "modem", NULL);
+	env->network = tcore_fake_network_new(env->modem);
+	tcore_fake_network_set_plmn(env->network, "45001");
+	tcore_fake_network_set_service_type(env->network, NETWORK_SERVICE_TYPE_3G);
+
+	env->plugin = tcore_plugin_new(env->server, &plugin_define_desc, "vconf-plugin.so", NULL);
+	if (!plugin_define_desc.load() || !plugin_define_desc.init(env->plugin))
+		g_error("vconf-plugin init failed");
+
+	env->strg = tcore_server_find_storage(env->server, "vconf");
+	if (!env->strg)
+		g_error("no vconf storage");
+
+	bench_env_settle();
+	vconf_fake_clear_stats();
+	calibrated = FALSE;
+}
+
+void bench_env_stop(struct bench_env *env)
+{
+	bench_env_settle();
+	plugin_define_desc.unload(env->plugin);
+	bench_env_settle();
+
+	tcore_plugin_free(env->plugin);
+	tcore_fake_network_free(env->network);
+	tcore_plugin_free(env->modem);
+	tcore_server_free(env->server);
+	memset(env, 0, sizeof(*env));
+}
+
+void bench_header(const char *title)
+{
+	printf("\n%s\n", title);
+	printf("%-40s %12s %12s %12s\n", "", "ns/op", "allocs/op", "writes/op");
+}
+
+static void noop(struct bench_env *env, guint i)
+{
+}
+
+static void measure(struct bench_env *env, BenchFunc func, guint iterations, struct measurement *m)
+{
+	struct vconf_fake_stats stats;
+	guint warmup = MAX(iterations / 10, 1);
+	gint64 t0, t1, call = 0, settle = 0;
+	guint64 a;
+	guint i;
+
+	for (i = 0; i < warmup; i++) {
+		func(env, i);
+		bench_env_settle();
+	}
+
+	vconf_fake_clear_stats();
+	a = bench_allocs();
+
+	for (i = 0; i < iterations; i++) {
+		t0 = bench_now_ns();
+		func(env, warmup + i);
+		t1 = bench_now_ns();
+		bench_env_settle();
+		call += t1 - t0;
+		settle += bench_now_ns() - t1;
+	}
+
+	vconf_fake_get_stats(&stats);
+	m->call_ns = (double)call / iterations;
+	m->settle_ns = (double)settle / iterations;
+	m->allocs = (double)(bench_allocs() - a) / iterations;
+	m->writes = (double)stats.writes / iterations;
+}
+
+/* the clock reads and the settling of an idle main loop are subtracted */
+void bench_run(struct bench_env *env, const char *name, BenchFunc func, guint iterations)
+{
+	struct measurement m;
+
+	if (!calibrated) {
+		measure(env, noop, 100000, &base);
+		calibrated = TRUE;
+	}
+
+	measure(env, func, iterations, &m);
+
+	bench_print(name, MAX(m.call_ns - base.call_ns, 0) + MAX(m.settle_ns - base.settle_ns, 0),
+			MAX(m.allocs - base.allocs, 0), m.writes);
+}
+
+void bench_print(const char *name, double ns, double allocs, double writes)
+{
+	printf("%-40s %12.1f %12.2f %12.2f\n", name, ns, allocs, writes);
+}
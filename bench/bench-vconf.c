@@ -0,0 +1,691 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * tel-vconf-bench: microbenchmarks of vconf-plugin, run against the
+ * in-memory vconf
+ *
+ * usage: tel-vconf-bench [iterations] [operators]
+ *
+ * Every case reports the time, the allocations (malloc family, all
+ * threads) and the vconf key writes per operation. Cases that go through
+ * the plugin include the main loop work they queue: echo notifications,
+ * idle reconciles and batch dispatches.
+ *
+ * The operator lookups run over a synthetic table the size of
+ * mcc_mnc_oper_list, or over operators, a file in the
+ * tel-vconf-operator-index input format.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+#include <vconf.h>
+
+#include <tcore.h>
+#include <server.h>
+#include <plugin.h>
+#include <storage.h>
+#include <co_network.h>
+
+#include "vconf-keys.h"
+#include "vconf-shm.h"
+#include "vconf-storage.h"
+#include "vconf-operator.h"
+#include "tcore-fake.h"
+#include "bench.h"
+
+#define BENCH_ITERATIONS 20000
+#define BENCH_OPERATORS 2000
+
+static const struct storage_operations *ops;
+
+static void key_changed(Storage *strg, enum tcore_storage_key key, void *value)
+{
+}
+
+static void op_create_remove_handle(struct bench_env *env, guint i)
+{
+	void *handle = ops->create_handle(env->strg, "bench");
+
+	ops->remove_handle(env->strg, handle);
+}
+
+static void op_set_int(struct bench_env *env, guint i)
+{
+	ops->set_int(env->strg, STORAGE_KEY_TELEPHONY_CALL_STATE, i & 1);
+}
+
+static void op_set_int_same(struct bench_env *env, guint i)
+{
+	ops->set_int(env->strg, STORAGE_KEY_TELEPHONY_CALL_STATE, 1);
+}
+
+static void op_set_bool(struct bench_env *env, guint i)
+{
+	ops->set_bool(env->strg, STORAGE_KEY_3G_ENABLE, i & 1);
+}
+
+static void op_set_string(struct bench_env *env, guint i)
+{
+	ops->set_string(env->strg, STORAGE_KEY_TELEPHONY_SAT_SETUP_IDLE_TEXT, i & 1 ? "idle text" : "other text");
+}
+
+static void op_get_int(struct bench_env *env, guint i)
+{
+	ops->get_int(env->strg, STORAGE_KEY_TELEPHONY_RSSI);
+}
+
+static void op_get_bool(struct bench_env *env, guint i)
+{
+	ops->get_bool(env->strg, STORAGE_KEY_TELEPHONY_READY);
+}
+
+static void op_get_string(struct bench_env *env, guint i)
+{
+	free(ops->get_string(env->strg, STORAGE_KEY_TELEPHONY_NWNAME));
+}
+
+static void op_key_callback(struct bench_env *env, guint i)
+{
+	ops->set_key_callback(env->strg, STORAGE_KEY_TELEPHONY_SIM_SLOT, key_changed);
+	ops->remove_key_callback(env->strg, STORAGE_KEY_TELEPHONY_SIM_SLOT);
+}
+
+/* operator name lookups: tcore's list against the index */
+static GArray *oper_rows;
+static GPtrArray *oper_strings;
+static CoreObject *oper_network;
+
+static const struct vconf_operator_row *oper_row(guint i)
+{
+	return &g_array_index(oper_rows, struct vconf_operator_row, (i * 7919u) % oper_rows->len);
+}
+
+static void oper_add(const char *mcc, const char *mnc, const char *country, const char *name)
+{
+	struct vconf_operator_row row;
+	char **f = g_new0(char *, 5);
+
+	f[0] = g_strdup(mcc);
+	f[1] = g_strdup(mnc);
+	f[2] = g_strdup(country);
+	f[3] = g_strdup(name);
+	g_ptr_array_add(oper_strings, f);
+
+	row.mcc = f[0];
+	row.mnc = f[1];
+	row.country = f[2];
+	row.name = f[3];
+	g_array_append_val(oper_rows, row);
+}
+
+static gboolean oper_load(const char *path)
+{
+	gchar *contents;
+	gchar **lines, **f;
+	guint i;
+
+	if (!g_file_get_contents(path, &contents, NULL, NULL))
+		return FALSE;
+
+	lines = g_strsplit(contents, "\n", -1);
+	for (i = 0; lines[i]; i++) {
+		g_strchomp(lines[i]);
+		if (!lines[i][0] || lines[i][0] == '#')
+			continue;
+
+		f = g_strsplit(lines[i], "\t", 4);
+		if (g_strv_length(f) == 4 && vconf_operator_key(f[0], f[1]) != VCONF_OPERATOR_KEY_INVALID)
+			oper_add(f[0], f[1], f[2], f[3]);
+		g_strfreev(f);
+	}
+	g_strfreev(lines);
+	g_free(contents);
+
+	return oper_rows->len > 0;
+}
+
+/* 500 MCCs with two 2-digit and two 3-digit MNCs each */
+static void oper_synthesize(void)
+{
+	char mcc[4], mnc[4], name[32];
+	guint i;
+
+	for (i = 0; i < BENCH_OPERATORS; i++) {
+		snprintf(mcc, sizeof(mcc), "%03u", 200 + i / 4);
+		snprintf(mnc, sizeof(mnc), i & 1 ? "%03u" : "%02u", i % 4);
+		snprintf(name, sizeof(name), "Operator %u", i);
+		oper_add(mcc, mnc, "BCH", name);
+	}
+}
+
+static void oper_tcore_find(struct bench_env *env, guint i)
+{
+	const struct vconf_operator_row *row = oper_row(i);
+
+	tcore_network_operator_info_find(oper_network, row->mcc, row->mnc);
+}
+
+static void oper_index_find(struct bench_env *env, guint i)
+{
+	const struct vconf_operator_row *row = oper_row(i);
+	const char *country;
+
+	vconf_operator_index_find(row->mcc, row->mnc, &country);
+}
+
+static void oper_tcore_miss(struct bench_env *env, guint i)
+{
+	tcore_network_operator_info_find(oper_network, "999", "99");
+}
+
+static void oper_index_miss(struct bench_env *env, guint i)
+{
+	vconf_operator_index_find("999", "99", NULL);
+}
+
+static void bench_operators(struct bench_env *env, guint n, const char *path)
+{
+	struct tcore_network_operator_info noi;
+	const struct vconf_operator_row *row;
+	gchar *data;
+	gsize size;
+	gint64 t0;
+	guint64 a;
+	guint i;
+
+	oper_rows = g_array_new(FALSE, FALSE, sizeof(struct vconf_operator_row));
+	oper_strings = g_ptr_array_new_with_free_func((GDestroyNotify)g_strfreev);
+	if (path && !oper_load(path)) {
+		printf("\n%s: no operators, using the synthetic table\n", path);
+		path = NULL;
+	}
+	if (!path)
+		oper_synthesize();
+
+	oper_network = tcore_fake_network_new(NULL);
+	for (i = 0; i < oper_rows->len; i++) {
+		row = &g_array_index(oper_rows, struct vconf_operator_row, i);
+		memset(&noi, 0, sizeof(noi));
+		g_strlcpy(noi.mcc, row->mcc, sizeof(noi.mcc));
+		g_strlcpy(noi.mnc, row->mnc, sizeof(noi.mnc));
+		g_strlcpy(noi.country, row->country, sizeof(noi.country));
+		g_strlcpy(noi.name, row->name, sizeof(noi.name));
+		tcore_network_operator_info_add(oper_network, &noi);
+	}
+
+	printf("\noperator lookup (%u operators%s%s)\n", oper_rows->len, path ? ", " : "", path ? path : "");
+	printf("%-40s %12s %12s %12s\n", "", "ns/op", "allocs/op", "writes/op");
+
+	/* what the plugin does once when the first lookup misses tcore */
+	a = bench_allocs();
+	t0 = bench_now_ns();
+	data = vconf_operator_index_build((const struct vconf_operator_row *)oper_rows->data, oper_rows->len, &size);
+	if (!vconf_operator_index_load(data, size))
+		g_error("operator index load failed");
+	bench_print("vconf_operator_index_build+load", bench_now_ns() - t0, bench_allocs() - a, 0);
+
+	bench_run(env, "tcore_network_operator_info_find", oper_tcore_find, n);
+	bench_run(env, "vconf_operator_index_find", oper_index_find, n);
+	bench_run(env, "tcore_network_operator_info_find (miss)", oper_tcore_miss, n);
+	bench_run(env, "vconf_operator_index_find (miss)", oper_index_miss, n);
+
+	vconf_operator_index_close();
+	tcore_fake_network_free(oper_network);
+	g_ptr_array_free(oper_strings, TRUE);
+	g_array_free(oper_rows, TRUE);
+}
+
+/* a registration view: what a consumer reads after a network change */
+static const enum tcore_storage_key multi_keys[] = {
+	STORAGE_KEY_TELEPHONY_PLMN,
+	STORAGE_KEY_TELEPHONY_LAC,
+	STORAGE_KEY_TELEPHONY_CELLID,
+	STORAGE_KEY_TELEPHONY_SVCTYPE,
+	STORAGE_KEY_TELEPHONY_SVC_ROAM,
+	STORAGE_KEY_TELEPHONY_NWNAME,
+};
+
+static void multi_single(struct bench_env *env, guint i)
+{
+	unsigned int j;
+
+	for (j = 0; j < G_N_ELEMENTS(multi_keys); j++) {
+		if (multi_keys[j] & STORAGE_KEY_STRING)
+			free(ops->get_string(env->strg, multi_keys[j]));
+		else if (multi_keys[j] & STORAGE_KEY_BOOL)
+			ops->get_bool(env->strg, multi_keys[j]);
+		else
+			ops->get_int(env->strg, multi_keys[j]);
+	}
+}
+
+static void multi_get(struct bench_env *env, guint i)
+{
+	struct vconf_storage_value values[G_N_ELEMENTS(multi_keys)];
+	unsigned int j;
+
+	vconf_storage_get_multi(env->strg, multi_keys, values, G_N_ELEMENTS(multi_keys));
+	for (j = 0; j < G_N_ELEMENTS(multi_keys); j++)
+		free(values[j].sval);
+}
+
+static void bench_multi(struct bench_env *env, guint n)
+{
+	ops = tcore_fake_storage_ops(env->strg);
+	ops->set_string(env->strg, STORAGE_KEY_TELEPHONY_NWNAME, "bench network");
+	bench_env_settle();
+
+	bench_header("multi-key read (6 keys)");
+	bench_run(env, "get_int/get_bool/get_string x 6", multi_single, n);
+	bench_run(env, "vconf_storage_get_multi", multi_get, n);
+}
+
+/* another process writes the key; the plugin dispatches the change */
+static void dispatch_int(struct bench_env *env, guint i)
+{
+	vconf_set_int(VCONFKEY_TELEPHONY_CALL_STATE, i & 1);
+}
+
+static void dispatch_bool(struct bench_env *env, guint i)
+{
+	vconf_set_bool(VCONFKEY_3G_ENABLE, i & 1);
+}
+
+static void dispatch_string(struct bench_env *env, guint i)
+{
+	vconf_set_str(VCONFKEY_TELEPHONY_SAT_SETUP_IDLE_TEXT, i & 1 ? "idle text" : "other text");
+}
+
+/* readers of the shared-memory mirror against the vconf path */
+#define SHM_SNAPSHOT_MAX 256
+
+static VconfShm *shm;
+static Storage *shm_strg;
+static int shm_slot_int;
+static int shm_slot_str;
+static struct vconf_shm_entry shm_entries[SHM_SNAPSHOT_MAX];
+
+static void shm_vconf_get_int(struct bench_env *env, guint i)
+{
+	int value;
+
+	vconf_get_int(VCONFKEY_TELEPHONY_RSSI, &value);
+}
+
+static void shm_reader_get_int(struct bench_env *env, guint i)
+{
+	int value;
+
+	vconf_shm_get_int(shm, shm_slot_int, &value);
+}
+
+static void shm_reader_find_get_int(struct bench_env *env, guint i)
+{
+	int value;
+
+	vconf_shm_get_int(shm, vconf_shm_find(shm, VCONFKEY_TELEPHONY_RSSI), &value);
+}
+
+static void shm_vconf_get_str(struct bench_env *env, guint i)
+{
+	free(vconf_get_str(VCONFKEY_TELEPHONY_NWNAME));
+}
+
+static void shm_reader_get_str(struct bench_env *env, guint i)
+{
+	char buf[VCONF_SHM_STR_MAX];
+
+	vconf_shm_get_str(shm, shm_slot_str, buf, sizeof(buf));
+}
+
+static void shm_vconf_get_all(struct bench_env *env, guint i)
+{
+	int value;
+	int j;
+
+	for (j = 0; j < SHM_SNAPSHOT_MAX && shm_entries[j].name[0]; j++) {
+		if (shm_entries[j].type == VCONF_SHM_TYPE_STRING)
+			free(vconf_get_str(shm_entries[j].name));
+		else
+			vconf_get_int(shm_entries[j].name, &value);
+	}
+}
+
+static void shm_reader_snapshot(struct bench_env *env, guint i)
+{
+	vconf_shm_snapshot(shm, shm_entries, SHM_SNAPSHOT_MAX);
+}
+
+static void shm_storage_get_int(struct bench_env *env, guint i)
+{
+	tcore_fake_storage_ops(shm_strg)->get_int(shm_strg, STORAGE_KEY_TELEPHONY_RSSI);
+}
+
+static void shm_storage_get_string(struct bench_env *env, guint i)
+{
+	free(tcore_fake_storage_ops(shm_strg)->get_string(shm_strg, STORAGE_KEY_TELEPHONY_NWNAME));
+}
+
+static void bench_shm(guint n)
+{
+	struct bench_env env;
+
+	bench_env_start(&env, "[general]\nshm=true\n");
+	ops = tcore_fake_storage_ops(env.strg);
+	ops->set_int(env.strg, STORAGE_KEY_TELEPHONY_RSSI, 3);
+	ops->set_string(env.strg, STORAGE_KEY_TELEPHONY_NWNAME, "bench network");
+	bench_env_settle();
+
+	shm = vconf_shm_open();
+	shm_strg = tcore_server_find_storage(env.server, "vconf-shm");
+	if (!shm || !shm_strg) {
+		printf("\nshared memory mirror unavailable, skipped\n");
+		goto out;
+	}
+
+	shm_slot_int = vconf_shm_find(shm, VCONFKEY_TELEPHONY_RSSI);
+	shm_slot_str = vconf_shm_find(shm, VCONFKEY_TELEPHONY_NWNAME);
+	memset(shm_entries, 0, sizeof(shm_entries));
+	vconf_shm_snapshot(shm, shm_entries, SHM_SNAPSHOT_MAX);
+
+	bench_header("shared memory reader");
+	bench_run(&env, "vconf_get_int", shm_vconf_get_int, n);
+	bench_run(&env, "vconf_shm_get_int", shm_reader_get_int, n);
+	bench_run(&env, "vconf_shm_find+vconf_shm_get_int", shm_reader_find_get_int, n);
+	bench_run(&env, "vconf_get_str", shm_vconf_get_str, n);
+	bench_run(&env, "vconf_shm_get_str", shm_reader_get_str, n);
+	bench_run(&env, "vconf_get_* of every mirrored key", shm_vconf_get_all, n);
+	bench_run(&env, "vconf_shm_snapshot", shm_reader_snapshot, n);
+	bench_run(&env, "vconf-shm get_int", shm_storage_get_int, n);
+	bench_run(&env, "vconf-shm get_string", shm_storage_get_string, n);
+
+	vconf_shm_close(shm);
+	shm = NULL;
+
+out:
+	bench_env_stop(&env);
+}
+
+static void notify(struct bench_env *env, enum tcore_notification_command command, unsigned int data_len, void *data)
+{
+	tcore_server_send_notification(env->server, env->network, command, data_len, data);
+}
+
+static void hook_cellinfo(struct bench_env *env, guint i)
+{
+	struct tnoti_network_location_cellinfo info = { 0x1000 + (i & 7), 0x20000 + i };
+
+	notify(env, TNOTI_NETWORK_LOCATION_CELLINFO, sizeof(info), &info);
+}
+
+static void hook_icon_info(struct bench_env *env, guint i)
+{
+	struct tnoti_network_icon_info info = { 0, i % 6, 0, 0 };
+
+	notify(env, TNOTI_NETWORK_ICON_INFO, sizeof(info), &info);
+}
+
+static void hook_registration_status(struct bench_env *env, guint i)
+{
+	struct tnoti_network_registration_status info;
+
+	info.cs_domain_status = NETWORK_SERVICE_DOMAIN_STATUS_FULL;
+	info.ps_domain_status = i & 1 ? NETWORK_SERVICE_DOMAIN_STATUS_FULL : NETWORK_SERVICE_DOMAIN_STATUS_NO;
+	info.service_type = i & 2 ? NETWORK_SERVICE_TYPE_3G : NETWORK_SERVICE_TYPE_HSDPA;
+	info.roaming_status = 0;
+
+	notify(env, TNOTI_NETWORK_REGISTRATION_STATUS, sizeof(info), &info);
+}
+
+static void hook_network_change(struct bench_env *env, guint i)
+{
+	struct tnoti_network_change info;
+
+	memset(&info, 0, sizeof(info));
+	snprintf(info.plmn, sizeof(info.plmn), "%s", i & 1 ? "45001" : "45005");
+	info.gsm.lac = 0x1000 + (i & 7);
+	tcore_fake_network_set_plmn(env->network, info.plmn);
+
+	notify(env, TNOTI_NETWORK_CHANGE, sizeof(info), &info);
+}
+
+static void hook_sim_status(struct bench_env *env, guint i)
+{
+	static const enum tel_sim_status status[] = {
+		SIM_STATUS_INITIALIZING, SIM_STATUS_PIN_REQUIRED, SIM_STATUS_INIT_COMPLETED, SIM_STATUS_CARD_REMOVED,
+	};
+	struct tnoti_sim_status info = { status[i % G_N_ELEMENTS(status)], 0 };
+
+	notify(env, TNOTI_SIM_STATUS, sizeof(info), &info);
+}
+
+static void hook_pb_status(struct bench_env *env, guint i)
+{
+	struct tnoti_phonebook_status info = { i & 1 };
+
+	notify(env, TNOTI_PHONEBOOK_STATUS, sizeof(info), &info);
+}
+
+static void hook_ps_protocol_status(struct bench_env *env, guint i)
+{
+	struct tnoti_ps_protocol_status info = { i % 4 };
+
+	notify(env, TNOTI_PS_PROTOCOL_STATUS, sizeof(info), &info);
+}
+
+static void hook_modem_power(struct bench_env *env, guint i)
+{
+	struct tnoti_modem_power info = { i & 1 ? MODEM_STATE_ONLINE : MODEM_STATE_OFFLINE };
+
+	notify(env, TNOTI_MODEM_POWER, sizeof(info), &info);
+}
+
+static void hook_modem_crash(struct bench_env *env, guint i)
+{
+	struct tnoti_modem_power info = { i & 1 ? MODEM_STATE_ONLINE : MODEM_STATE_ERROR };
+
+	notify(env, TNOTI_MODEM_POWER, sizeof(info), &info);
+}
+
+#define KEY_NAME(id, strg_key, name) name,
+#define PLUGIN_KEY_NAME(id, name, type) name,
+
+static const char *key_names[] = {
+	VCONF_STORAGE_KEYS(KEY_NAME)
+	VCONF_PLUGIN_KEYS(PLUGIN_KEY_NAME)
+};
+
+/* the g_str_equal() chain convert_vconf_to_strgkey() used to run */
+static int key_lookup_chain(const char *name)
+{
+	unsigned int i;
+
+	for (i = 0; i < G_N_ELEMENTS(key_names); i++) {
+		if (g_str_equal(name, key_names[i]))
+			return i;
+	}
+
+	return -1;
+}
+
+/* the index convert_vconf_to_id() looks up, built the same way */
+static GHashTable *key_index;
+
+static int key_lookup_index(const char *name)
+{
+	gpointer id = g_hash_table_lookup(key_index, name);
+
+	return id ? GPOINTER_TO_INT(id) - 1 : -1;
+}
+
+static void bench_key_lookup_single(const char *label, int (*lookup)(const char *name), const char *query, guint n)
+{
+	gint64 start;
+	guint64 allocs;
+	guint i, lookups = n * 16;
+	volatile int sink = 0;
+
+	allocs = bench_allocs();
+	start = bench_now_ns();
+
+	for (i = 0; i < lookups; i++)
+		sink += lookup(query);
+
+	bench_print(label, (double)(bench_now_ns() - start) / lookups,
+			(double)(bench_allocs() - allocs) / lookups, 0);
+	(void)sink;
+}
+
+static void bench_key_lookup_all(const char *label, int (*lookup)(const char *name), gchar **queries, guint n)
+{
+	gint64 start;
+	guint64 allocs;
+	guint round, k, lookups = n * G_N_ELEMENTS(key_names);
+	volatile int sink = 0;
+
+	allocs = bench_allocs();
+	start = bench_now_ns();
+
+	for (round = 0; round < n; round++) {
+		for (k = 0; k < G_N_ELEMENTS(key_names); k++)
+			sink += lookup(queries[k]);
+	}
+
+	bench_print(label, (double)(bench_now_ns() - start) / lookups,
+			(double)(bench_allocs() - allocs) / lookups, 0);
+	(void)sink;
+}
+
+/*
+ * vconf name -> key id over every key. The queries are copies, like the
+ * names of the keynodes vconf hands to callbacks.
+ */
+static void bench_key_lookup(guint n)
+{
+	gchar *queries[G_N_ELEMENTS(key_names)];
+	gchar label[64];
+	unsigned int k;
+
+	key_index = g_hash_table_new(g_str_hash, g_str_equal);
+	for (k = 0; k < G_N_ELEMENTS(key_names); k++) {
+		g_hash_table_insert(key_index, (gpointer)key_names[k], GINT_TO_POINTER(k + 1));
+		queries[k] = g_strdup(key_names[k]);
+	}
+
+	bench_header("key lookup (per lookup)");
+	bench_key_lookup_all("g_str_equal chain, all keys", key_lookup_chain, queries, n);
+	bench_key_lookup_all("index, all keys", key_lookup_index, queries, n);
+
+	/* the packet counters were the last keys of the chain */
+	for (k = 0; k < G_N_ELEMENTS(key_names); k++) {
+		if (!g_str_has_prefix(key_names[k], "db/dnet/statistics/cellular/"))
+			continue;
+
+		g_snprintf(label, sizeof(label), "chain, %s", strrchr(key_names[k], '/') + 1);
+		bench_key_lookup_single(label, key_lookup_chain, queries[k], n);
+		g_snprintf(label, sizeof(label), "index, %s", strrchr(key_names[k], '/') + 1);
+		bench_key_lookup_single(label, key_lookup_index, queries[k], n);
+	}
+
+	for (k = 0; k < G_N_ELEMENTS(key_names); k++)
+		g_free(queries[k]);
+	g_hash_table_destroy(key_index);
+}
+
+static void bench_ops(struct bench_env *env, guint n)
+{
+	ops = tcore_fake_storage_ops(env->strg);
+
+	bench_header("storage ops");
+	bench_run(env, "create_handle+remove_handle", op_create_remove_handle, n);
+	bench_run(env, "set_int", op_set_int, n);
+	bench_run(env, "set_int (unchanged)", op_set_int_same, n);
+	bench_run(env, "set_bool", op_set_bool, n);
+	bench_run(env, "set_string", op_set_string, n);
+	bench_run(env, "get_int", op_get_int, n);
+	bench_run(env, "get_bool", op_get_bool, n);
+	bench_run(env, "get_string", op_get_string, n);
+	bench_run(env, "set_key_callback+remove_key_callback", op_key_callback, n);
+}
+
+/*
+ * vconf change notification -> key cache -> storage subscribers. The
+ * writes/op column counts the external write itself. tel-vconf-check
+ * fails when the int or bool case allocates in the plugin.
+ */
+static void bench_dispatch(struct bench_env *env, guint n)
+{
+	ops = tcore_fake_storage_ops(env->strg);
+	ops->set_key_callback(env->strg, STORAGE_KEY_TELEPHONY_CALL_STATE, key_changed);
+	ops->set_key_callback(env->strg, STORAGE_KEY_3G_ENABLE, key_changed);
+	ops->set_key_callback(env->strg, STORAGE_KEY_TELEPHONY_SAT_SETUP_IDLE_TEXT, key_changed);
+
+	bench_header("notification dispatch");
+	bench_run(env, "int key", dispatch_int, n);
+	bench_run(env, "bool key", dispatch_bool, n);
+	bench_run(env, "string key", dispatch_string, n);
+
+	ops->remove_key_callback(env->strg, STORAGE_KEY_TELEPHONY_CALL_STATE);
+	ops->remove_key_callback(env->strg, STORAGE_KEY_3G_ENABLE);
+	ops->remove_key_callback(env->strg, STORAGE_KEY_TELEPHONY_SAT_SETUP_IDLE_TEXT);
+}
+
+static void bench_hooks(struct bench_env *env, guint n)
+{
+	bench_header("notification hooks");
+	bench_run(env, "network_location_cellinfo", hook_cellinfo, n);
+	bench_run(env, "network_icon_info", hook_icon_info, n);
+	bench_run(env, "network_registration_status", hook_registration_status, n);
+	bench_run(env, "network_change", hook_network_change, n);
+	bench_run(env, "sim_status", hook_sim_status, n);
+	bench_run(env, "phonebook_status", hook_pb_status, n);
+	bench_run(env, "ps_protocol_status", hook_ps_protocol_status, n);
+	bench_run(env, "modem_power", hook_modem_power, n);
+	bench_run(env, "modem_power (cp crash)", hook_modem_crash, n / 10 ? n / 10 : 1);
+}
+
+int main(int argc, char *argv[])
+{
+	struct bench_env env;
+	guint n = BENCH_ITERATIONS;
+
+	if (argc > 1)
+		n = MAX(atoi(argv[1]), 1);
+
+	bench_key_lookup(n);
+
+	bench_env_start(&env, NULL);
+	bench_ops(&env, n);
+	bench_multi(&env, n);
+	bench_dispatch(&env, n);
+	bench_hooks(&env, n);
+	bench_operators(&env, n, argc > 2 ? argv[2] : NULL);
+	bench_env_stop(&env);
+
+	bench_shm(n);
+
+	printf("\npeak rss %ld KiB\n", bench_peak_rss());
+
+	return 0;
+}
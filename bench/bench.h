@@ -0,0 +1,74 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+/*
+ * Benchmark harness: runs vconf-plugin against the in-memory vconf and
+ * the tcore stand-in (bench/fake) on a plain Linux host.
+ */
+#include <glib.h>
+
+#include <tcore.h>
+#include <server.h>
+#include <plugin.h>
+#include <storage.h>
+
+struct bench_env {
+	Server *server;
+	TcorePlugin *plugin;		/* vconf-plugin */
+	TcorePlugin *modem;		/* owns the network object */
+	CoreObject *network;
+	Storage *strg;			/* "vconf" */
+};
+
+/* malloc()s and friends since start, counted by bench-alloc.c */
+guint64 bench_allocs(void);
+
+gint64 bench_now_ns(void);
+
+/* peak resident set size, KiB */
+long bench_peak_rss(void);
+
+/*
+ * Writes conf (GKeyFile text, may be NULL) to the plugin configuration,
+ * provisions the keys of vconf-schema.h and runs the plugin's load and
+ * init against a fresh Server.
+ */
+void bench_env_start(struct bench_env *env, const char *conf);
+void bench_env_stop(struct bench_env *env);
+
+/* runs the main loop until nothing is pending */
+void bench_env_settle(void);
+
+typedef void (*BenchFunc)(struct bench_env *env, guint i);
+
+/*
+ * Runs func iterations times after a short warm-up, settling the main
+ * loop after every call, and prints ns/op, allocs/op and backend
+ * writes/op net of the cost of settling an idle loop.
+ */
+void bench_run(struct bench_env *env, const char *name, BenchFunc func, guint iterations);
+
+void bench_header(const char *title);
+void bench_print(const char *name, double ns, double allocs, double writes);
+
+#endif
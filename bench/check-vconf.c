@@ -0,0 +1,398 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * tel-vconf-check: behaviour checks of vconf-plugin, run against the
+ * in-memory vconf
+ *
+ * usage: tel-vconf-check
+ *
+ * Every check starts the plugin in a fresh environment with its own
+ * configuration. The exit status is the number of failed checks.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+#include <vconf.h>
+
+#include <tcore.h>
+#include <server.h>
+#include <plugin.h>
+#include <storage.h>
+
+#include "vconf-storage.h"
+#include "vconf-writer.h"
+#include "vconf-fake.h"
+#include "tcore-fake.h"
+#include "bench.h"
+
+#define CHECK(expr) \
+	do { \
+		if (!(expr)) { \
+			printf("  %s:%d: %s\n", __FILE__, __LINE__, #expr); \
+			return FALSE; \
+		} \
+	} while (0)
+
+struct check {
+	const char *name;
+	const char *conf;
+	gboolean (*func)(struct bench_env *env, const struct storage_operations *ops);
+};
+
+static int vconf_int(const char *name)
+{
+	int value = -1;
+
+	vconf_get_int(name, &value);
+	return value;
+}
+
+/* a LOW key reads back its new value before the low lane is flushed */
+static gboolean check_low_lane_get(struct bench_env *env, const struct storage_operations *ops)
+{
+	struct vconf_storage_value value;
+	enum tcore_storage_key key = STORAGE_KEY_TELEPHONY_RSSI;
+
+	CHECK(ops->set_int(env->strg, key, 3));
+	CHECK(ops->get_int(env->strg, key) == 3);
+	CHECK(vconf_storage_get_multi(env->strg, &key, &value, 1) == 1 && value.ival == 3);
+
+	bench_env_settle();
+	CHECK(vconf_int(VCONFKEY_TELEPHONY_RSSI) == 3);
+	CHECK(ops->get_int(env->strg, key) == 3);
+	return TRUE;
+}
+
+/* a value held back by the rate limit reads back before it is published */
+static gboolean check_policy_get(struct bench_env *env, const struct storage_operations *ops)
+{
+	struct vconf_storage_value value;
+	enum tcore_storage_key key = STORAGE_KEY_TELEPHONY_RSSI;
+
+	CHECK(ops->set_int(env->strg, key, 2));
+	bench_env_settle();
+	CHECK(vconf_int(VCONFKEY_TELEPHONY_RSSI) == 2);
+
+	CHECK(ops->set_int(env->strg, key, 5));
+	bench_env_settle();
+	CHECK(vconf_int(VCONFKEY_TELEPHONY_RSSI) == 2);
+	CHECK(ops->get_int(env->strg, key) == 5);
+	CHECK(vconf_storage_get_multi(env->strg, &key, &value, 1) == 1 && value.ival == 5);
+	return TRUE;
+}
+
+/* suppressed writes of the key so far, from the metrics dump */
+static guint key_suppressed(const char *name)
+{
+	gchar *dump = vconf_storage_dump_metrics(FALSE);
+	gchar **lines = g_strsplit(dump, "\n", -1);
+	guint writes, suppressed = 0;
+	gsize len = strlen(name);
+	guint i;
+
+	for (i = 0; lines[i]; i++) {
+		if (strncmp(lines[i], name, len) == 0 && lines[i][len] == ' ')
+			sscanf(lines[i] + len, " writes=%u suppressed=%u", &writes, &suppressed);
+	}
+
+	g_strfreev(lines);
+	g_free(dump);
+	return suppressed;
+}
+
+/* the plugin flushes the packet counters on every PM state change */
+static void pkt_flush(void)
+{
+	static int state = VCONFKEY_PM_STATE_NORMAL;
+
+	state = state == VCONFKEY_PM_STATE_NORMAL ? VCONFKEY_PM_STATE_LCDOFF : VCONFKEY_PM_STATE_NORMAL;
+	vconf_set_int(VCONFKEY_PM_STATE, state);
+	bench_env_settle();
+}
+
+static gboolean pkt_total(struct bench_env *env, enum tcore_storage_key key, gint64 expected)
+{
+	gint64 value = -1;
+
+	return vconf_storage_get_int64(env->strg, key, &value) && value == expected;
+}
+
+/* TOTAL counters carry a 32-bit wrap into the 64-bit total */
+static gboolean check_pkt_wrap(struct bench_env *env, const struct storage_operations *ops)
+{
+	enum tcore_storage_key key = STORAGE_KEY_CELLULAR_PKT_TOTAL_RCV;
+
+	CHECK(vconf_storage_set_int64(env->strg, key, 0));
+	CHECK(ops->set_int(env->strg, key, (int)0xFFFFFF00u));
+	CHECK(pkt_total(env, key, G_GINT64_CONSTANT(0xFFFFFF00)));
+
+	CHECK(ops->set_int(env->strg, key, 0x10));
+	CHECK(pkt_total(env, key, G_GINT64_CONSTANT(0x100000010)));
+	CHECK(ops->get_int(env->strg, key) == 0x10);
+
+	CHECK(ops->set_int(env->strg, key, 0x20));
+	CHECK(pkt_total(env, key, G_GINT64_CONSTANT(0x100000020)));
+
+	/* flushed as the low 32 bits, the full total is kept aside */
+	pkt_flush();
+	CHECK(vconf_int(VCONFKEY_NETWORK_CELLULAR_PKT_TOTAL_RCV) == 0x20);
+	CHECK(pkt_total(env, key, G_GINT64_CONSTANT(0x100000020)));
+	return TRUE;
+}
+
+/* a drop that is no wrap, or an outside write of the key, restarts the total */
+static gboolean check_pkt_reset(struct bench_env *env, const struct storage_operations *ops)
+{
+	enum tcore_storage_key key = STORAGE_KEY_CELLULAR_PKT_TOTAL_SNT;
+
+	CHECK(vconf_storage_set_int64(env->strg, key, G_GINT64_CONSTANT(0x100000000) + 0x5000));
+	CHECK(ops->set_int(env->strg, key, 3));
+	CHECK(pkt_total(env, key, 3));
+
+	CHECK(ops->set_int(env->strg, key, 0x4000));
+	CHECK(pkt_total(env, key, 0x4000));
+	CHECK(ops->set_int(env->strg, key, 0));
+	CHECK(pkt_total(env, key, 0));
+
+	CHECK(ops->set_int(env->strg, key, 0x9000));
+	pkt_flush();
+
+	vconf_set_int(VCONFKEY_NETWORK_CELLULAR_PKT_TOTAL_SNT, 0);
+	bench_env_settle();
+	CHECK(pkt_total(env, key, 0));
+	CHECK(ops->get_int(env->strg, key) == 0);
+	return TRUE;
+}
+
+/* only pushes that do not reach vconf count as suppressed */
+static gboolean check_pkt_suppressed(struct bench_env *env, const struct storage_operations *ops)
+{
+	enum tcore_storage_key key = STORAGE_KEY_CELLULAR_PKT_LAST_RCV;
+	const char *name = VCONFKEY_NETWORK_CELLULAR_PKT_LAST_RCV;
+	guint before = key_suppressed(name);
+
+	/* first change after a flush: written by the next flush */
+	CHECK(ops->set_int(env->strg, key, 100));
+	CHECK(key_suppressed(name) == before);
+
+	/* unchanged, and replacing a value never written */
+	CHECK(ops->set_int(env->strg, key, 100));
+	CHECK(ops->set_int(env->strg, key, 200));
+	CHECK(key_suppressed(name) == before + 2);
+
+	pkt_flush();
+	CHECK(vconf_int(VCONFKEY_NETWORK_CELLULAR_PKT_LAST_RCV) == 200);
+
+	CHECK(ops->set_int(env->strg, key, 300));
+	CHECK(key_suppressed(name) == before + 2);
+	return TRUE;
+}
+
+/*
+ * Notification dispatch of int and bool keys allocates nothing. Only the
+ * plugin side is counted: the other process' write happens before, and
+ * the in-memory vconf delivers notifications without allocating.
+ */
+#define CHECK_DISPATCH_ROUNDS 1000
+
+static void key_changed(Storage *strg, enum tcore_storage_key key, void *value)
+{
+}
+
+static void write_int(guint i)
+{
+	vconf_set_int(VCONFKEY_TELEPHONY_CALL_STATE, i & 1);
+}
+
+static void write_bool(guint i)
+{
+	vconf_set_bool(VCONFKEY_3G_ENABLE, i & 1);
+}
+
+static void write_none(guint i)
+{
+}
+
+static guint64 dispatch_allocs(void (*write)(guint i))
+{
+	guint64 total = 0, start;
+	guint i;
+
+	for (i = 0; i < 2 * CHECK_DISPATCH_ROUNDS; i++) {
+		write(i);
+
+		start = bench_allocs();
+		vconf_fake_dispatch();
+		bench_env_settle();
+
+		/* the first half warms up */
+		if (i >= CHECK_DISPATCH_ROUNDS)
+			total += bench_allocs() - start;
+	}
+
+	return total;
+}
+
+static gboolean check_dispatch_allocs(struct bench_env *env, const struct storage_operations *ops)
+{
+	guint64 idle, allocs;
+
+	CHECK(ops->set_key_callback(env->strg, STORAGE_KEY_TELEPHONY_CALL_STATE, key_changed));
+	CHECK(ops->set_key_callback(env->strg, STORAGE_KEY_3G_ENABLE, key_changed));
+
+	idle = dispatch_allocs(write_none);
+
+	allocs = dispatch_allocs(write_int);
+	if (allocs > idle)
+		printf("  int key: %.2f allocs per notification\n", (double)(allocs - idle) / CHECK_DISPATCH_ROUNDS);
+	CHECK(allocs <= idle);
+
+	allocs = dispatch_allocs(write_bool);
+	if (allocs > idle)
+		printf("  bool key: %.2f allocs per notification\n", (double)(allocs - idle) / CHECK_DISPATCH_ROUNDS);
+	CHECK(allocs <= idle);
+	return TRUE;
+}
+
+/* waits until the worker has taken the queued write (write_queue=1) */
+static void writer_wait_taken(void)
+{
+	while (vconf_writer_full())
+		g_usleep(1000);
+}
+
+/*
+ * A coalesced write takes the tail of the queue and a critical write
+ * waits behind the queued ones: vconf sees the writes in program order.
+ */
+static gboolean check_writer_order(struct bench_env *env, const struct storage_operations *ops)
+{
+	const char *log[8];
+
+	vconf_fake_clear_stats();
+	vconf_fake_hold_writes(TRUE);
+
+	CHECK(ops->set_string(env->strg, STORAGE_KEY_TELEPHONY_NWNAME, "held"));
+	CHECK(ops->set_int(env->strg, STORAGE_KEY_TELEPHONY_LAC, 1));
+	CHECK(ops->set_int(env->strg, STORAGE_KEY_TELEPHONY_CELLID, 1));
+	CHECK(ops->set_int(env->strg, STORAGE_KEY_TELEPHONY_LAC, 2));
+	CHECK(ops->set_int(env->strg, STORAGE_KEY_TELEPHONY_SIM_SLOT, VCONFKEY_TELEPHONY_SIM_INSERTED));
+
+	vconf_fake_hold_writes(FALSE);
+	bench_env_settle();
+
+	CHECK(vconf_fake_get_write_log(log, G_N_ELEMENTS(log)) == 4);
+	CHECK(g_str_equal(log[0], VCONFKEY_TELEPHONY_NWNAME));
+	CHECK(g_str_equal(log[1], VCONFKEY_TELEPHONY_CELLID));
+	CHECK(g_str_equal(log[2], VCONFKEY_TELEPHONY_LAC));
+	CHECK(g_str_equal(log[3], VCONFKEY_TELEPHONY_SIM_SLOT));
+	CHECK(vconf_int(VCONFKEY_TELEPHONY_LAC) == 2);
+	return TRUE;
+}
+
+/* a full queue refuses new keys without blocking and still coalesces */
+static gboolean check_writer_full(struct bench_env *env, const struct storage_operations *ops)
+{
+	struct vconf_fake_stats stats;
+	int cellid = ops->get_int(env->strg, STORAGE_KEY_TELEPHONY_CELLID);
+
+	vconf_fake_hold_writes(TRUE);
+
+	CHECK(ops->set_string(env->strg, STORAGE_KEY_TELEPHONY_NWNAME, "held"));
+	writer_wait_taken();
+	CHECK(ops->set_int(env->strg, STORAGE_KEY_TELEPHONY_LAC, 1));
+	CHECK(!ops->set_int(env->strg, STORAGE_KEY_TELEPHONY_CELLID, cellid + 1));
+	CHECK(ops->get_int(env->strg, STORAGE_KEY_TELEPHONY_CELLID) == cellid);
+	CHECK(ops->set_int(env->strg, STORAGE_KEY_TELEPHONY_LAC, 2));
+
+	vconf_fake_hold_writes(FALSE);
+	bench_env_settle();
+	CHECK(vconf_int(VCONFKEY_TELEPHONY_LAC) == 2);
+	CHECK(vconf_int(VCONFKEY_TELEPHONY_CELLID) == cellid);
+
+	/* the refused value was not cached, so it is written now */
+	vconf_fake_clear_stats();
+	CHECK(ops->set_int(env->strg, STORAGE_KEY_TELEPHONY_CELLID, cellid + 1));
+	bench_env_settle();
+	vconf_fake_get_stats(&stats);
+	CHECK(stats.writes == 1);
+	CHECK(vconf_int(VCONFKEY_TELEPHONY_CELLID) == cellid + 1);
+	return TRUE;
+}
+
+/* a failed background write drops the cached value, so a retry is written */
+static gboolean check_writer_failure(struct bench_env *env, const struct storage_operations *ops)
+{
+	struct vconf_fake_stats stats;
+	int lac = vconf_int(VCONFKEY_TELEPHONY_LAC);
+
+	vconf_fake_fail_writes(TRUE);
+	CHECK(ops->set_int(env->strg, STORAGE_KEY_TELEPHONY_LAC, lac + 7));
+	bench_env_settle();
+	vconf_fake_fail_writes(FALSE);
+
+	CHECK(vconf_int(VCONFKEY_TELEPHONY_LAC) == lac);
+	CHECK(ops->get_int(env->strg, STORAGE_KEY_TELEPHONY_LAC) == lac);
+
+	vconf_fake_clear_stats();
+	CHECK(ops->set_int(env->strg, STORAGE_KEY_TELEPHONY_LAC, lac + 7));
+	bench_env_settle();
+	vconf_fake_get_stats(&stats);
+	CHECK(stats.writes == 1);
+	CHECK(vconf_int(VCONFKEY_TELEPHONY_LAC) == lac + 7);
+	return TRUE;
+}
+
+static const struct check checks[] = {
+	{ "low lane set then get", NULL, check_low_lane_get },
+	{ "rate limited set then get", "[memory/telephony/rssi]\nmin_interval=60000\n", check_policy_get },
+	{ "int and bool dispatch allocate nothing", NULL, check_dispatch_allocs },
+	{ "packet counter wrap", NULL, check_pkt_wrap },
+	{ "packet counter reset", NULL, check_pkt_reset },
+	{ "packet counter suppressed pushes", NULL, check_pkt_suppressed },
+	{ "write-behind order", "[general]\nwrite_behind=true\n", check_writer_order },
+	{ "write-behind full queue", "[general]\nwrite_behind=true\nwrite_queue=1\n", check_writer_full },
+	{ "write-behind failure", "[general]\nwrite_behind=true\n", check_writer_failure },
+};
+
+int main(int argc, char *argv[])
+{
+	struct bench_env env;
+	unsigned int i;
+	int failed = 0;
+
+	for (i = 0; i < G_N_ELEMENTS(checks); i++) {
+		gboolean ok;
+
+		bench_env_start(&env, checks[i].conf);
+		ok = checks[i].func(&env, tcore_fake_storage_ops(env.strg));
+		bench_env_stop(&env);
+
+		printf("%s: %s\n", ok ? "PASS" : "FAIL", checks[i].name);
+		if (!ok)
+			failed++;
+	}
+
+	return failed;
+}
@@ -0,0 +1,417 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include <tcore.h>
+#include <server.h>
+#include <plugin.h>
+#include <storage.h>
+#include <co_network.h>
+
+#include "tcore-fake.h"
+
+struct tcore_server_type {
+	GSList *plugins;
+	GSList *storages;
+	GSList *hooks;
+};
+
+struct tcore_plugin_type {
+	Server *server;
+	const struct tcore_plugin_define_desc *desc;
+	gchar *filename;
+	GSList *objects;
+};
+
+struct tcore_storage_type {
+	TcorePlugin *plugin;
+	gchar *name;
+	struct storage_operations *ops;
+};
+
+struct tcore_object_type {
+	TcorePlugin *plugin;
+	gchar *plmn;
+	enum telephony_network_service_type service_type;
+	enum tcore_network_name_priority name_priority;
+	gchar *names[TCORE_NETWORK_NAME_TYPE_SPN + 1];
+	GSList *operators;
+};
+
+struct hook_type {
+	enum tcore_notification_command command;
+	TcoreServerNotificationHook func;
+	void *user_data;
+};
+
+static gboolean verbose;
+
+void tcore_fake_log(enum tcore_fake_log_level level, const char *fmt, ...)
+{
+	va_list ap;
+
+	if (!verbose && level == TCORE_FAKE_LOG_DEBUG)
+		return;
+
+	va_start(ap, fmt);
+	vfprintf(stderr, fmt, ap);
+	va_end(ap);
+	fputc('\n', stderr);
+}
+
+void tcore_fake_set_verbose(gboolean v)
+{
+	verbose = v;
+}
+
+Server *tcore_server_new(void)
+{
+	return g_new0(Server, 1);
+}
+
+void tcore_server_free(Server *s)
+{
+	if (!s)
+		return;
+
+	g_slist_free_full(s->hooks, g_free);
+	g_slist_free(s->storages);
+	g_slist_free(s->plugins);
+	g_free(s);
+}
+
+GSList *tcore_server_ref_plugins(Server *s)
+{
+	return s ? s->plugins : NULL;
+}
+
+Storage *tcore_server_find_storage(Server *s, const char *name)
+{
+	GSList *l;
+
+	if (!s || !name)
+		return NULL;
+
+	for (l = s->storages; l; l = l->next) {
+		Storage *strg = l->data;
+
+		if (g_strcmp0(strg->name, name) == 0)
+			return strg;
+	}
+
+	return NULL;
+}
+
+TReturn tcore_server_add_notification_hook(Server *s, enum tcore_notification_command command,
+		TcoreServerNotificationHook hook, void *user_data)
+{
+	struct hook_type *h;
+
+	if (!s || !hook)
+		return TCORE_RETURN_EINVAL;
+
+	h = g_new0(struct hook_type, 1);
+	h->command = command;
+	h->func = hook;
+	h->user_data = user_data;
+	s->hooks = g_slist_append(s->hooks, h);
+
+	return TCORE_RETURN_SUCCESS;
+}
+
+TReturn tcore_server_remove_notification_hook(Server *s, TcoreServerNotificationHook hook)
+{
+	GSList *l, *next;
+
+	if (!s)
+		return TCORE_RETURN_EINVAL;
+
+	for (l = s->hooks; l; l = next) {
+		struct hook_type *h = l->data;
+
+		next = l->next;
+		if (h->func != hook)
+			continue;
+
+		s->hooks = g_slist_delete_link(s->hooks, l);
+		g_free(h);
+	}
+
+	return TCORE_RETURN_SUCCESS;
+}
+
+TReturn tcore_server_send_notification(Server *s, CoreObject *source, enum tcore_notification_command command,
+		unsigned int data_len, void *data)
+{
+	GSList *l;
+
+	if (!s)
+		return TCORE_RETURN_EINVAL;
+
+	for (l = s->hooks; l; l = l->next) {
+		struct hook_type *h = l->data;
+
+		if (h->command != command)
+			continue;
+
+		if (h->func(s, source, command, data_len, data, h->user_data) == TCORE_HOOK_RETURN_STOP_PROPAGATION)
+			break;
+	}
+
+	return TCORE_RETURN_SUCCESS;
+}
+
+TcorePlugin *tcore_plugin_new(Server *server, const struct tcore_plugin_define_desc *desc,
+		const char *filename, void *handle)
+{
+	TcorePlugin *p;
+
+	p = g_new0(TcorePlugin, 1);
+	p->server = server;
+	p->desc = desc;
+	p->filename = g_strdup(filename);
+
+	if (server)
+		server->plugins = g_slist_append(server->plugins, p);
+
+	return p;
+}
+
+void tcore_plugin_free(TcorePlugin *p)
+{
+	if (!p)
+		return;
+
+	if (p->server)
+		p->server->plugins = g_slist_remove(p->server->plugins, p);
+
+	g_slist_free(p->objects);
+	g_free(p->filename);
+	g_free(p);
+}
+
+const struct tcore_plugin_define_desc *tcore_plugin_get_description(TcorePlugin *p)
+{
+	return p ? p->desc : NULL;
+}
+
+Server *tcore_plugin_ref_server(TcorePlugin *p)
+{
+	return p ? p->server : NULL;
+}
+
+GSList *tcore_plugin_ref_core_objects(TcorePlugin *p)
+{
+	return p ? p->objects : NULL;
+}
+
+Storage *tcore_storage_new(TcorePlugin *p, const char *name, struct storage_operations *ops)
+{
+	Storage *strg;
+
+	strg = g_new0(Storage, 1);
+	strg->plugin = p;
+	strg->name = g_strdup(name);
+	strg->ops = ops;
+
+	if (p && p->server)
+		p->server->storages = g_slist_append(p->server->storages, strg);
+
+	return strg;
+}
+
+void tcore_storage_free(Storage *strg)
+{
+	if (!strg)
+		return;
+
+	if (strg->plugin && strg->plugin->server)
+		strg->plugin->server->storages = g_slist_remove(strg->plugin->server->storages, strg);
+
+	g_free(strg->name);
+	g_free(strg);
+}
+
+const char *tcore_storage_ref_name(Storage *strg)
+{
+	return strg ? strg->name : NULL;
+}
+
+TcorePlugin *tcore_storage_ref_plugin(Storage *strg)
+{
+	return strg ? strg->plugin : NULL;
+}
+
+void *tcore_storage_create_handle(Storage *strg, const char *path)
+{
+	if (!strg || !strg->ops->create_handle)
+		return NULL;
+
+	return strg->ops->create_handle(strg, path);
+}
+
+gboolean tcore_storage_remove_handle(Storage *strg, void *handle)
+{
+	if (!strg || !strg->ops->remove_handle)
+		return FALSE;
+
+	return strg->ops->remove_handle(strg, handle);
+}
+
+gboolean tcore_storage_read_query_database(Storage *strg, void *handle, const char *query,
+		GHashTable *in_param, GHashTable *out_param, int out_param_cnt)
+{
+	if (!strg || !strg->ops->read_query_database)
+		return FALSE;
+
+	return strg->ops->read_query_database(strg, handle, query, in_param, out_param, out_param_cnt);
+}
+
+const struct storage_operations *tcore_fake_storage_ops(Storage *strg)
+{
+	return strg ? strg->ops : NULL;
+}
+
+CoreObject *tcore_fake_network_new(TcorePlugin *p)
+{
+	CoreObject *co;
+
+	co = g_new0(CoreObject, 1);
+	co->plugin = p;
+	co->name_priority = TCORE_NETWORK_NAME_PRIORITY_NETWORK;
+
+	if (p)
+		p->objects = g_slist_append(p->objects, co);
+
+	return co;
+}
+
+void tcore_fake_network_free(CoreObject *co)
+{
+	unsigned int i;
+
+	if (!co)
+		return;
+
+	if (co->plugin)
+		co->plugin->objects = g_slist_remove(co->plugin->objects, co);
+
+	for (i = 0; i < G_N_ELEMENTS(co->names); i++)
+		g_free(co->names[i]);
+
+	g_slist_free_full(co->operators, g_free);
+	g_free(co->plmn);
+	g_free(co);
+}
+
+void tcore_fake_network_set_plmn(CoreObject *co, const char *plmn)
+{
+	g_free(co->plmn);
+	co->plmn = g_strdup(plmn);
+}
+
+void tcore_fake_network_set_service_type(CoreObject *co, enum telephony_network_service_type type)
+{
+	co->service_type = type;
+}
+
+void tcore_fake_network_set_name(CoreObject *co, enum tcore_network_name_type type, const char *name)
+{
+	g_free(co->names[type]);
+	co->names[type] = g_strdup(name);
+}
+
+void tcore_fake_network_set_name_priority(CoreObject *co, enum tcore_network_name_priority priority)
+{
+	co->name_priority = priority;
+}
+
+/* like libtcore, the getters return strdup()ed copies the caller free()s */
+char *tcore_network_get_plmn(CoreObject *co)
+{
+	if (!co || !co->plmn)
+		return NULL;
+
+	return strdup(co->plmn);
+}
+
+TReturn tcore_network_get_service_type(CoreObject *co, enum telephony_network_service_type *service_type)
+{
+	if (!co || !service_type)
+		return TCORE_RETURN_EINVAL;
+
+	*service_type = co->service_type;
+	return TCORE_RETURN_SUCCESS;
+}
+
+TReturn tcore_network_get_network_name_priority(CoreObject *co, enum tcore_network_name_priority *priority)
+{
+	if (!co || !priority)
+		return TCORE_RETURN_EINVAL;
+
+	*priority = co->name_priority;
+	return TCORE_RETURN_SUCCESS;
+}
+
+char *tcore_network_get_network_name(CoreObject *co, enum tcore_network_name_type type)
+{
+	if (!co || type > TCORE_NETWORK_NAME_TYPE_SPN || !co->names[type])
+		return NULL;
+
+	return strdup(co->names[type]);
+}
+
+TReturn tcore_network_operator_info_add(CoreObject *co, struct tcore_network_operator_info *noi)
+{
+	struct tcore_network_operator_info *copy;
+
+	if (!co || !noi)
+		return TCORE_RETURN_EINVAL;
+
+	copy = g_new(struct tcore_network_operator_info, 1);
+	*copy = *noi;
+	co->operators = g_slist_prepend(co->operators, copy);
+	return TCORE_RETURN_SUCCESS;
+}
+
+/* a linear list walk, as in libtcore */
+struct tcore_network_operator_info *tcore_network_operator_info_find(CoreObject *co,
+		const char *mcc, const char *mnc)
+{
+	GSList *l;
+
+	if (!co || !mcc || !mnc)
+		return NULL;
+
+	for (l = co->operators; l; l = l->next) {
+		struct tcore_network_operator_info *noi = l->data;
+
+		if (g_strcmp0(noi->mcc, mcc) == 0 && g_strcmp0(noi->mnc, mnc) == 0)
+			return noi;
+	}
+
+	return NULL;
+}
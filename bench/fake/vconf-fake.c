@@ -0,0 +1,584 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+#include <vconf.h>
+
+#include "vconf-fake.h"
+
+#define FAKE_PENDING_MAX 8192		/* notifications queued before dropping */
+#define FAKE_STR_MAX 256		/* string values carried by a notification */
+#define FAKE_WATCH_MAX 16		/* watchers called per notification */
+#define FAKE_LOG_MAX 1024		/* key writes logged in order */
+
+struct _keynode_t {
+	char *keyname;
+	int type;
+	union {
+		int i;
+		int b;
+		double d;
+		char *s;
+	} value;
+	struct _keynode_t *next;
+};
+
+struct _keylist_t {
+	int num;
+	keynode_t *head;
+	keynode_t *tail;
+	keynode_t *cursor;
+};
+
+struct fake_watch {
+	vconf_callback_fn cb;
+	void *user_data;
+};
+
+struct fake_key {
+	gchar *name;
+	int type;
+	int i;
+	gchar *s;
+	gsize s_size;			/* reused while a new value fits */
+	GSList *watches;
+};
+
+/* copied at write time, so a notification carries the value written */
+struct fake_pending {
+	struct fake_key *key;
+	int type;
+	int i;
+	gboolean null_str;
+	char s[FAKE_STR_MAX];
+};
+
+static GMutex lock;
+static GHashTable *keys;
+static struct fake_pending pending[FAKE_PENDING_MAX];
+static guint pending_head;
+static gint pending_count;
+static struct vconf_fake_stats stats;
+static GSource *source;
+
+static void key_free(gpointer data)
+{
+	struct fake_key *k = data;
+
+	g_slist_free_full(k->watches, g_free);
+	g_free(k->s);
+	g_free(k->name);
+	g_free(k);
+}
+
+/* with lock held */
+static struct fake_key *key_get(const char *name, gboolean create)
+{
+	struct fake_key *k;
+
+	if (!keys)
+		keys = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, key_free);
+
+	k = g_hash_table_lookup(keys, name);
+	if (k || !create)
+		return k;
+
+	k = g_new0(struct fake_key, 1);
+	k->name = g_strdup(name);
+	g_hash_table_insert(keys, k->name, k);
+
+	return k;
+}
+
+static gboolean source_prepare(GSource *s, gint *timeout)
+{
+	*timeout = -1;
+	return g_atomic_int_get(&pending_count) > 0;
+}
+
+static gboolean source_check(GSource *s)
+{
+	return g_atomic_int_get(&pending_count) > 0;
+}
+
+static gboolean source_dispatch(GSource *s, GSourceFunc callback, gpointer user_data)
+{
+	vconf_fake_dispatch();
+	return G_SOURCE_CONTINUE;
+}
+
+static GSourceFuncs source_funcs = {
+	source_prepare,
+	source_check,
+	source_dispatch,
+	NULL,
+};
+
+/* with lock held; one persistent source, so queueing does not allocate */
+static void pending_push(struct fake_key *k)
+{
+	struct fake_pending *p;
+
+	if (!k->watches)
+		return;
+
+	if (pending_count == FAKE_PENDING_MAX) {
+		g_warning("vconf fake: notification queue full, %s dropped", k->name);
+		return;
+	}
+
+	p = &pending[(pending_head + pending_count) % FAKE_PENDING_MAX];
+	p->key = k;
+	p->type = k->type;
+	p->i = k->i;
+	p->null_str = !k->s;
+	if (k->s)
+		g_strlcpy(p->s, k->s, sizeof(p->s));
+
+	g_atomic_int_inc(&pending_count);
+
+	if (!source) {
+		source = g_source_new(&source_funcs, sizeof(GSource));
+		g_source_attach(source, NULL);
+	}
+	g_main_context_wakeup(NULL);
+}
+
+static void key_store_str(struct fake_key *k, const char *value)
+{
+	gsize len = strlen(value) + 1;
+
+	if (len > k->s_size) {
+		g_free(k->s);
+		k->s = g_malloc(len);
+		k->s_size = len;
+	}
+	memcpy(k->s, value, len);
+}
+
+/* write controls of vconf-fake.h */
+static GCond hold_cond;
+static gboolean hold_writes;
+static gboolean fail_writes;
+static const char *write_log[FAKE_LOG_MAX];
+static unsigned int write_log_count;
+
+static int set_value(const char *name, int type, int i, const char *s)
+{
+	struct fake_key *k;
+
+	if (!name || (type == VCONF_TYPE_STRING && !s))
+		return -1;
+
+	g_mutex_lock(&lock);
+
+	while (hold_writes)
+		g_cond_wait(&hold_cond, &lock);
+
+	if (fail_writes) {
+		g_mutex_unlock(&lock);
+		return -1;
+	}
+
+	k = key_get(name, TRUE);
+	if (write_log_count < FAKE_LOG_MAX)
+		write_log[write_log_count++] = k->name;
+	k->type = type;
+	if (type == VCONF_TYPE_STRING)
+		key_store_str(k, s);
+	else
+		k->i = i;
+
+	stats.writes++;
+	pending_push(k);
+
+	g_mutex_unlock(&lock);
+
+	return 0;
+}
+
+int vconf_set_int(const char *in_key, const int intval)
+{
+	return set_value(in_key, VCONF_TYPE_INT, intval, NULL);
+}
+
+int vconf_set_bool(const char *in_key, const int boolval)
+{
+	return set_value(in_key, VCONF_TYPE_BOOL, !!boolval, NULL);
+}
+
+int vconf_set_str(const char *in_key, const char *strval)
+{
+	return set_value(in_key, VCONF_TYPE_STRING, 0, strval);
+}
+
+int vconf_set(keylist_t *keylist)
+{
+	keynode_t *n;
+
+	if (!keylist)
+		return -1;
+
+	for (n = keylist->head; n; n = n->next) {
+		if (set_value(n->keyname, n->type, n->type == VCONF_TYPE_STRING ? 0 : n->value.i, n->value.s) != 0)
+			return -1;
+	}
+
+	return 0;
+}
+
+static int get_value(const char *name, int type, int *i, char **s)
+{
+	struct fake_key *k;
+	int ret = -1;
+
+	if (!name)
+		return -1;
+
+	g_mutex_lock(&lock);
+
+	stats.reads++;
+	k = key_get(name, FALSE);
+	if (k && k->type == type) {
+		if (type == VCONF_TYPE_STRING)
+			*s = strdup(k->s);
+		else
+			*i = k->i;
+		ret = 0;
+	}
+
+	g_mutex_unlock(&lock);
+
+	return ret;
+}
+
+int vconf_get_int(const char *in_key, int *intval)
+{
+	if (!intval)
+		return -1;
+
+	return get_value(in_key, VCONF_TYPE_INT, intval, NULL);
+}
+
+int vconf_get_bool(const char *in_key, int *boolval)
+{
+	if (!boolval)
+		return -1;
+
+	return get_value(in_key, VCONF_TYPE_BOOL, boolval, NULL);
+}
+
+/* like vconf, the copy is malloc()ed */
+char *vconf_get_str(const char *in_key)
+{
+	char *s = NULL;
+
+	if (get_value(in_key, VCONF_TYPE_STRING, NULL, &s) != 0)
+		return NULL;
+
+	return s;
+}
+
+int vconf_notify_key_changed(const char *in_key, vconf_callback_fn cb, void *user_data)
+{
+	struct fake_key *k;
+	struct fake_watch *w;
+
+	if (!in_key || !cb)
+		return -1;
+
+	g_mutex_lock(&lock);
+
+	k = key_get(in_key, TRUE);
+	w = g_new0(struct fake_watch, 1);
+	w->cb = cb;
+	w->user_data = user_data;
+	k->watches = g_slist_append(k->watches, w);
+
+	g_mutex_unlock(&lock);
+
+	return 0;
+}
+
+int vconf_ignore_key_changed(const char *in_key, vconf_callback_fn cb)
+{
+	struct fake_key *k;
+	GSList *l;
+	int ret = -1;
+
+	if (!in_key || !cb)
+		return -1;
+
+	g_mutex_lock(&lock);
+
+	k = key_get(in_key, FALSE);
+	for (l = k ? k->watches : NULL; l; l = l->next) {
+		struct fake_watch *w = l->data;
+
+		if (w->cb != cb)
+			continue;
+
+		k->watches = g_slist_delete_link(k->watches, l);
+		g_free(w);
+		ret = 0;
+		break;
+	}
+
+	g_mutex_unlock(&lock);
+
+	return ret;
+}
+
+unsigned int vconf_fake_dispatch(void)
+{
+	struct fake_watch watches[FAKE_WATCH_MAX];
+	struct fake_pending p;
+	keynode_t node;
+	unsigned int n, i, count = 0;
+	GSList *l;
+
+	for (;;) {
+		g_mutex_lock(&lock);
+
+		if (!pending_count) {
+			g_mutex_unlock(&lock);
+			break;
+		}
+
+		/* copied out, so callbacks may queue new notifications */
+		p = pending[pending_head];
+		pending_head = (pending_head + 1) % FAKE_PENDING_MAX;
+		g_atomic_int_add(&pending_count, -1);
+
+		/* callbacks may add or remove watches: call a copy */
+		n = 0;
+		for (l = p.key->watches; l && n < FAKE_WATCH_MAX; l = l->next)
+			watches[n++] = *(struct fake_watch *)l->data;
+
+		memset(&node, 0, sizeof(node));
+		node.keyname = p.key->name;
+		node.type = p.type;
+		if (p.type == VCONF_TYPE_STRING)
+			node.value.s = p.null_str ? NULL : p.s;
+		else
+			node.value.i = p.i;
+
+		stats.notifications += n;
+
+		g_mutex_unlock(&lock);
+
+		for (i = 0; i < n; i++)
+			watches[i].cb(&node, watches[i].user_data);
+
+		count++;
+	}
+
+	return count;
+}
+
+void vconf_fake_reset(void)
+{
+	g_mutex_lock(&lock);
+
+	if (keys)
+		g_hash_table_destroy(keys);
+	keys = NULL;
+	pending_head = 0;
+	g_atomic_int_set(&pending_count, 0);
+	memset(&stats, 0, sizeof(stats));
+	write_log_count = 0;
+	fail_writes = FALSE;
+
+	g_mutex_unlock(&lock);
+}
+
+void vconf_fake_get_stats(struct vconf_fake_stats *s)
+{
+	g_mutex_lock(&lock);
+	*s = stats;
+	g_mutex_unlock(&lock);
+}
+
+void vconf_fake_clear_stats(void)
+{
+	g_mutex_lock(&lock);
+	memset(&stats, 0, sizeof(stats));
+	write_log_count = 0;
+	g_mutex_unlock(&lock);
+}
+
+void vconf_fake_hold_writes(gboolean hold)
+{
+	g_mutex_lock(&lock);
+	hold_writes = hold;
+	g_cond_broadcast(&hold_cond);
+	g_mutex_unlock(&lock);
+}
+
+void vconf_fake_fail_writes(gboolean fail)
+{
+	g_mutex_lock(&lock);
+	fail_writes = fail;
+	g_mutex_unlock(&lock);
+}
+
+unsigned int vconf_fake_get_write_log(const char **names, unsigned int max)
+{
+	unsigned int i, count;
+
+	g_mutex_lock(&lock);
+	count = MIN(write_log_count, max);
+	for (i = 0; i < count; i++)
+		names[i] = write_log[i];
+	g_mutex_unlock(&lock);
+
+	return count;
+}
+
+char *vconf_keynode_get_name(keynode_t *keynode)
+{
+	return keynode ? keynode->keyname : NULL;
+}
+
+int vconf_keynode_get_type(keynode_t *keynode)
+{
+	return keynode ? keynode->type : -1;
+}
+
+int vconf_keynode_get_int(const keynode_t *keynode)
+{
+	if (!keynode || keynode->type != VCONF_TYPE_INT)
+		return -1;
+
+	return keynode->value.i;
+}
+
+double vconf_keynode_get_dbl(const keynode_t *keynode)
+{
+	if (!keynode || keynode->type != VCONF_TYPE_DOUBLE)
+		return -1;
+
+	return keynode->value.d;
+}
+
+int vconf_keynode_get_bool(const keynode_t *keynode)
+{
+	if (!keynode || keynode->type != VCONF_TYPE_BOOL)
+		return -1;
+
+	return keynode->value.b;
+}
+
+char *vconf_keynode_get_str(const keynode_t *keynode)
+{
+	if (!keynode || keynode->type != VCONF_TYPE_STRING)
+		return NULL;
+
+	return keynode->value.s;
+}
+
+keylist_t *vconf_keylist_new(void)
+{
+	return g_new0(keylist_t, 1);
+}
+
+int vconf_keylist_free(keylist_t *keylist)
+{
+	keynode_t *n, *next;
+
+	if (!keylist)
+		return -1;
+
+	for (n = keylist->head; n; n = next) {
+		next = n->next;
+		if (n->type == VCONF_TYPE_STRING)
+			g_free(n->value.s);
+		g_free(n->keyname);
+		g_free(n);
+	}
+	g_free(keylist);
+
+	return 0;
+}
+
+static keynode_t *keylist_add(keylist_t *keylist, const char *keyname, int type)
+{
+	keynode_t *n;
+
+	n = g_new0(keynode_t, 1);
+	n->keyname = g_strdup(keyname);
+	n->type = type;
+
+	if (keylist->tail)
+		keylist->tail->next = n;
+	else
+		keylist->head = n;
+	keylist->tail = n;
+
+	return n;
+}
+
+int vconf_keylist_add_int(keylist_t *keylist, const char *keyname, const int value)
+{
+	if (!keylist || !keyname)
+		return -1;
+
+	keylist_add(keylist, keyname, VCONF_TYPE_INT)->value.i = value;
+	return ++keylist->num;
+}
+
+int vconf_keylist_add_bool(keylist_t *keylist, const char *keyname, const int value)
+{
+	if (!keylist || !keyname)
+		return -1;
+
+	keylist_add(keylist, keyname, VCONF_TYPE_BOOL)->value.b = !!value;
+	return ++keylist->num;
+}
+
+int vconf_keylist_add_str(keylist_t *keylist, const char *keyname, const char *value)
+{
+	if (!keylist || !keyname || !value)
+		return -1;
+
+	keylist_add(keylist, keyname, VCONF_TYPE_STRING)->value.s = g_strdup(value);
+	return ++keylist->num;
+}
+
+keynode_t *vconf_keylist_nextnode(keylist_t *keylist)
+{
+	if (!keylist)
+		return NULL;
+
+	keylist->cursor = keylist->cursor ? keylist->cursor->next : keylist->head;
+	return keylist->cursor;
+}
+
+int vconf_keylist_rewind(keylist_t *keylist)
+{
+	if (!keylist)
+		return -1;
+
+	keylist->cursor = NULL;
+	return 0;
+}
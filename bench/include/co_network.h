@@ -0,0 +1,56 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __FAKE_CO_NETWORK_H__
+#define __FAKE_CO_NETWORK_H__
+
+#include <tcore.h>
+
+enum tcore_network_name_type {
+	TCORE_NETWORK_NAME_TYPE_SHORT,
+	TCORE_NETWORK_NAME_TYPE_FULL,
+	TCORE_NETWORK_NAME_TYPE_SPN
+};
+
+enum tcore_network_name_priority {
+	TCORE_NETWORK_NAME_PRIORITY_UNKNOWN,
+	TCORE_NETWORK_NAME_PRIORITY_NETWORK,
+	TCORE_NETWORK_NAME_PRIORITY_SPN,
+	TCORE_NETWORK_NAME_PRIORITY_ANY
+};
+
+struct tcore_network_operator_info {
+	char mcc[4];
+	char mnc[4];
+	char name[41];
+	char country[4];
+	int type;
+};
+
+char *tcore_network_get_plmn(CoreObject *co);
+TReturn tcore_network_get_service_type(CoreObject *co, enum telephony_network_service_type *service_type);
+TReturn tcore_network_get_network_name_priority(CoreObject *co, enum tcore_network_name_priority *priority);
+char *tcore_network_get_network_name(CoreObject *co, enum tcore_network_name_type type);
+
+TReturn tcore_network_operator_info_add(CoreObject *co, struct tcore_network_operator_info *noi);
+struct tcore_network_operator_info *tcore_network_operator_info_find(CoreObject *co,
+		const char *mcc, const char *mnc);
+
+#endif
@@ -0,0 +1,49 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __FAKE_PLUGIN_H__
+#define __FAKE_PLUGIN_H__
+
+#include <tcore.h>
+
+enum tcore_plugin_priority {
+	TCORE_PLUGIN_PRIORITY_HIGH = -100,
+	TCORE_PLUGIN_PRIORITY_MID = 0,
+	TCORE_PLUGIN_PRIORITY_LOW = +100
+};
+
+struct tcore_plugin_define_desc {
+	gchar *name;
+	enum tcore_plugin_priority priority;
+	int version;
+	gboolean (*load)(void);
+	gboolean (*init)(TcorePlugin *plugin);
+	void (*unload)(TcorePlugin *plugin);
+};
+
+TcorePlugin *tcore_plugin_new(Server *server, const struct tcore_plugin_define_desc *desc,
+		const char *filename, void *handle);
+void tcore_plugin_free(TcorePlugin *plugin);
+
+const struct tcore_plugin_define_desc *tcore_plugin_get_description(TcorePlugin *plugin);
+Server *tcore_plugin_ref_server(TcorePlugin *plugin);
+GSList *tcore_plugin_ref_core_objects(TcorePlugin *plugin);
+
+#endif
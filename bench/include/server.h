@@ -0,0 +1,43 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __FAKE_SERVER_H__
+#define __FAKE_SERVER_H__
+
+#include <tcore.h>
+
+typedef enum tcore_hook_return (*TcoreServerNotificationHook)(Server *s, CoreObject *source,
+		enum tcore_notification_command command, unsigned int data_len, void *data, void *user_data);
+
+Server *tcore_server_new(void);
+void tcore_server_free(Server *s);
+
+GSList *tcore_server_ref_plugins(Server *s);
+Storage *tcore_server_find_storage(Server *s, const char *name);
+
+TReturn tcore_server_add_notification_hook(Server *s, enum tcore_notification_command command,
+		TcoreServerNotificationHook hook, void *user_data);
+TReturn tcore_server_remove_notification_hook(Server *s, TcoreServerNotificationHook hook);
+
+/* runs the hooks of command in registration order until one stops it */
+TReturn tcore_server_send_notification(Server *s, CoreObject *source, enum tcore_notification_command command,
+		unsigned int data_len, void *data);
+
+#endif
@@ -0,0 +1,56 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __FAKE_STORAGE_H__
+#define __FAKE_STORAGE_H__
+
+#include <tcore.h>
+
+struct storage_operations {
+	void *(*create_handle)(Storage *strg, const char *path);
+	gboolean (*remove_handle)(Storage *strg, void *handle);
+	gboolean (*set_int)(Storage *strg, enum tcore_storage_key key, int value);
+	gboolean (*set_string)(Storage *strg, enum tcore_storage_key key, const char *value);
+	gboolean (*set_bool)(Storage *strg, enum tcore_storage_key key, gboolean value);
+	int (*get_int)(Storage *strg, enum tcore_storage_key key);
+	char *(*get_string)(Storage *strg, enum tcore_storage_key key);
+	gboolean (*get_bool)(Storage *strg, enum tcore_storage_key key);
+	gboolean (*set_key_callback)(Storage *strg, enum tcore_storage_key key, TcoreStorageDispatchCallback cb);
+	gboolean (*remove_key_callback)(Storage *strg, enum tcore_storage_key key);
+	gboolean (*update_query_database)(Storage *strg, void *handle, const char *query, GHashTable *in_param);
+	gboolean (*read_query_database)(Storage *strg, void *handle, const char *query,
+			GHashTable *in_param, GHashTable *out_param, int out_param_cnt);
+	gboolean (*insert_query_database)(Storage *strg, void *handle, const char *query, GHashTable *in_param);
+	gboolean (*remove_query_database)(Storage *strg, void *handle, const char *query, GHashTable *in_param);
+};
+
+Storage *tcore_storage_new(TcorePlugin *plugin, const char *name, struct storage_operations *ops);
+void tcore_storage_free(Storage *strg);
+
+const char *tcore_storage_ref_name(Storage *strg);
+TcorePlugin *tcore_storage_ref_plugin(Storage *strg);
+
+void *tcore_storage_create_handle(Storage *strg, const char *path);
+gboolean tcore_storage_remove_handle(Storage *strg, void *handle);
+
+gboolean tcore_storage_read_query_database(Storage *strg, void *handle, const char *query,
+		GHashTable *in_param, GHashTable *out_param, int out_param_cnt);
+
+#endif
@@ -0,0 +1,45 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __TCORE_FAKE_H__
+#define __TCORE_FAKE_H__
+
+/*
+ * Controls of the tcore stand-in, benchmarks only
+ *
+ * A Server holds plugins, storages and notification hooks; a network
+ * CoreObject holds the state the tcore_network_get_*() calls return.
+ */
+#include <tcore.h>
+#include <storage.h>
+#include <co_network.h>
+
+CoreObject *tcore_fake_network_new(TcorePlugin *p);
+void tcore_fake_network_free(CoreObject *co);
+
+void tcore_fake_network_set_plmn(CoreObject *co, const char *plmn);
+void tcore_fake_network_set_service_type(CoreObject *co, enum telephony_network_service_type type);
+void tcore_fake_network_set_name(CoreObject *co, enum tcore_network_name_type type, const char *name);
+void tcore_fake_network_set_name_priority(CoreObject *co, enum tcore_network_name_priority priority);
+
+/* the ops a storage was registered with */
+const struct storage_operations *tcore_fake_storage_ops(Storage *strg);
+
+#endif
@@ -0,0 +1,230 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __FAKE_TCORE_H__
+#define __FAKE_TCORE_H__
+
+/*
+ * Minimal stand-in for the libtcore headers, benchmarks only
+ * (bench/fake/tcore-fake.c)
+ *
+ * Declares the types, enums and notification payloads tel-plugin-vconf
+ * uses, with the names of the real headers. Logging goes through
+ * tcore_fake_log() and is silent unless tcore_fake_set_verbose() is set.
+ */
+
+#include <glib.h>
+
+typedef struct tcore_plugin_type TcorePlugin;
+typedef struct tcore_server_type Server;
+typedef struct tcore_object_type CoreObject;
+typedef struct tcore_storage_type Storage;
+
+enum tcore_return {
+	TCORE_RETURN_SUCCESS = 0,
+	TCORE_RETURN_FAILURE = -1,
+	TCORE_RETURN_EINVAL = 0x01000002,
+};
+
+typedef enum tcore_return TReturn;
+
+enum tcore_fake_log_level {
+	TCORE_FAKE_LOG_DEBUG,
+	TCORE_FAKE_LOG_WARN,
+	TCORE_FAKE_LOG_ERR,
+};
+
+void tcore_fake_log(enum tcore_fake_log_level level, const char *fmt, ...)
+	__attribute__((format(printf, 2, 3)));
+void tcore_fake_set_verbose(gboolean verbose);
+
+/* statement blocks like libtcore's, which callers rely on */
+#define dbg(fmt, ...) { tcore_fake_log(TCORE_FAKE_LOG_DEBUG, fmt, ##__VA_ARGS__); }
+#define msg(fmt, ...) { tcore_fake_log(TCORE_FAKE_LOG_DEBUG, fmt, ##__VA_ARGS__); }
+#define warn(fmt, ...) { tcore_fake_log(TCORE_FAKE_LOG_WARN, fmt, ##__VA_ARGS__); }
+#define err(fmt, ...) { tcore_fake_log(TCORE_FAKE_LOG_ERR, fmt, ##__VA_ARGS__); }
+
+enum tcore_hook_return {
+	TCORE_HOOK_RETURN_STOP_PROPAGATION,
+	TCORE_HOOK_RETURN_CONTINUE
+};
+
+enum tcore_notification_command {
+	TNOTI_NETWORK_LOCATION_CELLINFO = 1,
+	TNOTI_NETWORK_ICON_INFO,
+	TNOTI_NETWORK_REGISTRATION_STATUS,
+	TNOTI_NETWORK_CHANGE,
+	TNOTI_SIM_STATUS,
+	TNOTI_PHONEBOOK_STATUS,
+	TNOTI_PS_PROTOCOL_STATUS,
+	TNOTI_MODEM_POWER
+};
+
+#define STORAGE_KEY_INT 0x01000000
+#define STORAGE_KEY_BOOL 0x02000000
+#define STORAGE_KEY_STRING 0x04000000
+#define STORAGE_KEY_DOUBLE 0x08000000
+
+enum tcore_storage_key {
+	STORAGE_KEY_TELEPHONY_PLMN = STORAGE_KEY_INT | 1,
+	STORAGE_KEY_TELEPHONY_LAC,
+	STORAGE_KEY_TELEPHONY_CELLID,
+	STORAGE_KEY_TELEPHONY_SVCTYPE,
+	STORAGE_KEY_TELEPHONY_SVC_CS,
+	STORAGE_KEY_TELEPHONY_SVC_PS,
+	STORAGE_KEY_TELEPHONY_SVC_ROAM,
+	STORAGE_KEY_TELEPHONY_ZONE_TYPE,
+	STORAGE_KEY_TELEPHONY_SIM_INIT,
+	STORAGE_KEY_TELEPHONY_SIM_CHV,
+	STORAGE_KEY_TELEPHONY_SIM_PB_INIT,
+	STORAGE_KEY_TELEPHONY_CALL_STATE,
+	STORAGE_KEY_TELEPHONY_CALL_FORWARD_STATE,
+	STORAGE_KEY_TELEPHONY_TAPI_STATE,
+	STORAGE_KEY_TELEPHONY_SPN_DISP_CONDITION,
+	STORAGE_KEY_TELEPHONY_SAT_STATE,
+	STORAGE_KEY_TELEPHONY_ZONE_ZUHAUSE,
+	STORAGE_KEY_TELEPHONY_RSSI,
+	STORAGE_KEY_TELEPHONY_LOW_BATTERY,
+	STORAGE_KEY_TELEPHONY_EVENT_SYSTEM_READY,
+	STORAGE_KEY_TELEPHONY_SIM_SLOT,
+	STORAGE_KEY_PM_STATE,
+	STORAGE_KEY_PACKET_SERVICE_STATE,
+	STORAGE_KEY_MESSAGE_NETWORK_MODE,
+	STORAGE_KEY_CELLULAR_STATE,
+	STORAGE_KEY_CELLULAR_PKT_TOTAL_RCV,
+	STORAGE_KEY_CELLULAR_PKT_TOTAL_SNT,
+	STORAGE_KEY_CELLULAR_PKT_LAST_RCV,
+	STORAGE_KEY_CELLULAR_PKT_LAST_SNT,
+	STORAGE_KEY_TELEPHONY_READY = STORAGE_KEY_BOOL | 1,
+	STORAGE_KEY_3G_ENABLE,
+	STORAGE_KEY_SETAPPL_STATE_DATA_ROAMING_BOOL,
+	STORAGE_KEY_SETAPPL_STATE_AUTOMATIC_TIME_UPDATE_BOOL,
+	STORAGE_KEY_SETAPPL_FLIGHT_MODE_BOOL,
+	STORAGE_KEY_TELEPHONY_NWNAME = STORAGE_KEY_STRING | 1,
+	STORAGE_KEY_TELEPHONY_SPN_NAME,
+	STORAGE_KEY_TELEPHONY_SAT_SETUP_IDLE_TEXT,
+	STORAGE_KEY_TELEPHONY_IMEI,
+	STORAGE_KEY_TELEPHONY_SUBSCRIBER_NUMBER,
+	STORAGE_KEY_TELEPHONY_SUBSCRIBER_NAME,
+	STORAGE_KEY_TELEPHONY_SWVERSION,
+	STORAGE_KEY_TELEPHONY_HWVERSION,
+	STORAGE_KEY_TELEPHONY_CALDATE,
+	STORAGE_KEY_TELEPHONY_IMEI_FACTORY_REBOOT,
+	STORAGE_KEY_TELEPHONY_SIM_FACTORY_MODE,
+	STORAGE_KEY_TELEPHONY_PRODUCTCODE,
+	STORAGE_KEY_TELEPHONY_FACTORY_KSTRINGB,
+	STORAGE_KEY_TELEPHONY_IMSI
+};
+
+enum telephony_network_service_type {
+	NETWORK_SERVICE_TYPE_UNKNOWN,
+	NETWORK_SERVICE_TYPE_NO_SERVICE,
+	NETWORK_SERVICE_TYPE_EMERGENCY,
+	NETWORK_SERVICE_TYPE_SEARCH,
+	NETWORK_SERVICE_TYPE_2G,
+	NETWORK_SERVICE_TYPE_2_5G,
+	NETWORK_SERVICE_TYPE_2_5G_EDGE,
+	NETWORK_SERVICE_TYPE_3G,
+	NETWORK_SERVICE_TYPE_HSDPA
+};
+
+enum telephony_network_service_domain_status {
+	NETWORK_SERVICE_DOMAIN_STATUS_NO,
+	NETWORK_SERVICE_DOMAIN_STATUS_EMERGENCY,
+	NETWORK_SERVICE_DOMAIN_STATUS_FULL
+};
+
+enum telephony_ps_protocol_status {
+	TELEPHONY_HSDPA_OFF,
+	TELEPHONY_HSDPA_ON,
+	TELEPHONY_HSUPA_ON,
+	TELEPHONY_HSPA_ON
+};
+
+enum tel_sim_status {
+	SIM_STATUS_CARD_ERROR,
+	SIM_STATUS_CARD_NOT_PRESENT,
+	SIM_STATUS_CARD_REMOVED,
+	SIM_STATUS_INIT_COMPLETED,
+	SIM_STATUS_INITIALIZING,
+	SIM_STATUS_PIN_REQUIRED,
+	SIM_STATUS_PUK_REQUIRED,
+	SIM_STATUS_LOCK_REQUIRED,
+	SIM_STATUS_CARD_BLOCKED,
+	SIM_STATUS_NCK_REQUIRED,
+	SIM_STATUS_NSCK_REQUIRED,
+	SIM_STATUS_SPCK_REQUIRED,
+	SIM_STATUS_CCK_REQUIRED,
+	SIM_STATUS_UNKNOWN
+};
+
+enum modem_state {
+	MODEM_STATE_ONLINE,
+	MODEM_STATE_OFFLINE,
+	MODEM_STATE_ERROR
+};
+
+struct tnoti_network_location_cellinfo {
+	unsigned int lac;
+	unsigned int cell_id;
+};
+
+struct tnoti_network_icon_info {
+	int type;
+	int rssi;
+	int battery;
+	int hdr_rssi;
+};
+
+struct tnoti_network_registration_status {
+	enum telephony_network_service_domain_status cs_domain_status;
+	enum telephony_network_service_domain_status ps_domain_status;
+	enum telephony_network_service_type service_type;
+	int roaming_status;
+};
+
+struct tnoti_network_change {
+	int act;
+	char plmn[7];
+	struct {
+		unsigned int lac;
+	} gsm;
+};
+
+struct tnoti_sim_status {
+	enum tel_sim_status sim_status;
+	int b_changed;
+};
+
+struct tnoti_phonebook_status {
+	gboolean b_init;
+};
+
+struct tnoti_ps_protocol_status {
+	enum telephony_ps_protocol_status status;
+};
+
+struct tnoti_modem_power {
+	enum modem_state state;
+};
+
+typedef void (*TcoreStorageDispatchCallback)(Storage *strg, enum tcore_storage_key key, void *value);
+
+#endif
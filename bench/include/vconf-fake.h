@@ -0,0 +1,61 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VCONF_FAKE_H__
+#define __VCONF_FAKE_H__
+
+#include <glib.h>
+
+/*
+ * Controls of the in-memory vconf, benchmarks only
+ *
+ * Keys live in a hash table. Writes from any thread notify the watchers
+ * of the key from the default main context, like vconf's inotify
+ * dispatch does, so a plugin sees the echoes of its own writes.
+ */
+struct vconf_fake_stats {
+	unsigned int writes;		/* keys written, a keylist counts per key */
+	unsigned int reads;
+	unsigned int notifications;	/* watcher callbacks run */
+};
+
+/* drops all keys, watches and pending notifications */
+void vconf_fake_reset(void);
+
+void vconf_fake_get_stats(struct vconf_fake_stats *stats);
+/* also clears the write log */
+void vconf_fake_clear_stats(void);
+
+/*
+ * Writes from any thread wait while held. Holding writes and then
+ * writing from the holding thread deadlocks.
+ */
+void vconf_fake_hold_writes(gboolean hold);
+
+/* writes fail with -1 and change nothing; cleared by vconf_fake_reset() */
+void vconf_fake_fail_writes(gboolean fail);
+
+/* names of the keys written since the stats were cleared, in order */
+unsigned int vconf_fake_get_write_log(const char **names, unsigned int max);
+
+/* runs the pending notifications; returns how many */
+unsigned int vconf_fake_dispatch(void);
+
+#endif
@@ -0,0 +1,212 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __FAKE_VCONF_H__
+#define __FAKE_VCONF_H__
+
+/*
+ * In-memory stand-in for vconf, benchmarks only (bench/fake/vconf-fake.c)
+ *
+ * Declares the subset of the vconf API and the vconf-internal-keys names
+ * tel-plugin-vconf uses, with the signatures of the real headers.
+ */
+
+enum {
+	VCONF_TYPE_NONE = 0,
+	VCONF_TYPE_STRING = 40,
+	VCONF_TYPE_INT = 41,
+	VCONF_TYPE_DOUBLE = 42,
+	VCONF_TYPE_BOOL = 43,
+	VCONF_TYPE_DIR
+};
+
+typedef struct _keynode_t keynode_t;
+typedef struct _keylist_t keylist_t;
+
+typedef void (*vconf_callback_fn)(keynode_t *node, void *user_data);
+
+char *vconf_keynode_get_name(keynode_t *keynode);
+int vconf_keynode_get_type(keynode_t *keynode);
+int vconf_keynode_get_int(const keynode_t *keynode);
+double vconf_keynode_get_dbl(const keynode_t *keynode);
+int vconf_keynode_get_bool(const keynode_t *keynode);
+char *vconf_keynode_get_str(const keynode_t *keynode);
+
+keylist_t *vconf_keylist_new(void);
+int vconf_keylist_free(keylist_t *keylist);
+int vconf_keylist_add_int(keylist_t *keylist, const char *keyname, const int value);
+int vconf_keylist_add_bool(keylist_t *keylist, const char *keyname, const int value);
+int vconf_keylist_add_str(keylist_t *keylist, const char *keyname, const char *value);
+keynode_t *vconf_keylist_nextnode(keylist_t *keylist);
+int vconf_keylist_rewind(keylist_t *keylist);
+
+int vconf_set(keylist_t *keylist);
+int vconf_set_int(const char *in_key, const int intval);
+int vconf_set_bool(const char *in_key, const int boolval);
+int vconf_set_str(const char *in_key, const char *strval);
+
+int vconf_get_int(const char *in_key, int *intval);
+int vconf_get_bool(const char *in_key, int *boolval);
+char *vconf_get_str(const char *in_key);
+
+int vconf_notify_key_changed(const char *in_key, vconf_callback_fn cb, void *user_data);
+int vconf_ignore_key_changed(const char *in_key, vconf_callback_fn cb);
+
+/* vconf-internal-keys */
+#define VCONFKEY_TELEPHONY_PLMN "memory/telephony/plmn"
+#define VCONFKEY_TELEPHONY_LAC "memory/telephony/lac"
+#define VCONFKEY_TELEPHONY_CELLID "memory/telephony/cell_id"
+#define VCONFKEY_TELEPHONY_SVCTYPE "memory/telephony/svc_type"
+#define VCONFKEY_TELEPHONY_SVC_CS "memory/telephony/svc_cs"
+#define VCONFKEY_TELEPHONY_SVC_PS "memory/telephony/svc_ps"
+#define VCONFKEY_TELEPHONY_SVC_ROAM "memory/telephony/svc_roam"
+#define VCONFKEY_TELEPHONY_ZONE_TYPE "memory/telephony/zone_type"
+#define VCONFKEY_TELEPHONY_SIM_INIT "memory/telephony/sim_init"
+#define VCONFKEY_TELEPHONY_SIM_CHV "memory/telephony/sim_chv"
+#define VCONFKEY_TELEPHONY_SIM_PB_INIT "memory/telephony/pb_init"
+#define VCONFKEY_TELEPHONY_CALL_STATE "memory/telephony/call_state"
+#define VCONFKEY_TELEPHONY_CALL_FORWARD_STATE "memory/telephony/call_forward_state"
+#define VCONFKEY_TELEPHONY_TAPI_STATE "memory/telephony/tapi_state"
+#define VCONFKEY_TELEPHONY_SPN_DISP_CONDITION "memory/telephony/spn_disp_condition"
+#define VCONFKEY_TELEPHONY_SAT_STATE "memory/telephony/sat_state"
+#define VCONFKEY_TELEPHONY_ZONE_ZUHAUSE "memory/telephony/zuhause_zone"
+#define VCONFKEY_TELEPHONY_RSSI "memory/telephony/rssi"
+#define VCONFKEY_TELEPHONY_LOW_BATTERY "memory/telephony/low_battery"
+#define VCONFKEY_TELEPHONY_READY "memory/telephony/telephony_ready"
+#define VCONFKEY_TELEPHONY_SIM_SLOT "memory/telephony/sim_slot"
+#define VCONFKEY_PM_STATE "memory/pm/state"
+#define VCONFKEY_DNET_STATE "memory/dnet/state"
+#define VCONFKEY_MESSAGE_NETWORK_MODE "db/msg/network_mode"
+#define VCONFKEY_3G_ENABLE "db/setting/3gEnabled"
+#define VCONFKEY_SETAPPL_STATE_DATA_ROAMING_BOOL "db/setting/data_roaming"
+#define VCONFKEY_SETAPPL_STATE_AUTOMATIC_TIME_UPDATE_BOOL "db/setting/automatic_time_update"
+#define VCONFKEY_SETAPPL_FLIGHT_MODE_BOOL "db/telephony/flight_mode"
+#define VCONFKEY_TELEPHONY_NWNAME "memory/telephony/nw_name"
+#define VCONFKEY_TELEPHONY_SPN_NAME "memory/telephony/spn"
+#define VCONFKEY_TELEPHONY_SAT_SETUP_IDLE_TEXT "memory/telephony/idle_text"
+#define VCONFKEY_TELEPHONY_IMEI "memory/telephony/imei"
+#define VCONFKEY_TELEPHONY_SUBSCRIBER_NUMBER "memory/telephony/szSubscriberNumber"
+#define VCONFKEY_TELEPHONY_SUBSCRIBER_NAME "memory/telephony/szSubscriberAlpha"
+#define VCONFKEY_TELEPHONY_SWVERSION "memory/telephony/szSWVersion"
+#define VCONFKEY_TELEPHONY_HWVERSION "memory/telephony/szHWVersion"
+#define VCONFKEY_TELEPHONY_CALDATE "memory/telephony/szCalDate"
+#define VCONFKEY_TELEPHONY_IMEI_FACTORY_REBOOT "memory/telephony/imei_factory_rebooting"
+#define VCONFKEY_TELEPHONY_SIM_FACTORY_MODE "memory/telephony/sim_factory_mode"
+#define VCONFKEY_TELEPHONY_PRODUCTCODE "memory/telephony/productCode"
+#define VCONFKEY_TELEPHONY_FACTORY_KSTRINGB "memory/telephony/factory_kstringb"
+#define VCONFKEY_NETWORK_CELLULAR_STATE "memory/dnet/cellular"
+#define VCONFKEY_NETWORK_CELLULAR_PKT_TOTAL_RCV "db/dnet/statistics/cellular/totalrcv"
+#define VCONFKEY_NETWORK_CELLULAR_PKT_TOTAL_SNT "db/dnet/statistics/cellular/totalsnt"
+#define VCONFKEY_NETWORK_CELLULAR_PKT_LAST_RCV "db/dnet/statistics/cellular/lastrcv"
+#define VCONFKEY_NETWORK_CELLULAR_PKT_LAST_SNT "db/dnet/statistics/cellular/lastsnt"
+#define VCONFKEY_TELEPHONY_PSTYPE "memory/telephony/ps_type"
+
+enum {
+	VCONFKEY_TELEPHONY_SVCTYPE_NONE,
+	VCONFKEY_TELEPHONY_SVCTYPE_NOSVC,
+	VCONFKEY_TELEPHONY_SVCTYPE_EMERGENCY,
+	VCONFKEY_TELEPHONY_SVCTYPE_SEARCH,
+	VCONFKEY_TELEPHONY_SVCTYPE_2G
+};
+
+enum {
+	VCONFKEY_TELEPHONY_SVC_CS_UNKNOWN,
+	VCONFKEY_TELEPHONY_SVC_CS_OFF,
+	VCONFKEY_TELEPHONY_SVC_CS_ON
+};
+
+enum {
+	VCONFKEY_TELEPHONY_SVC_PS_UNKNOWN,
+	VCONFKEY_TELEPHONY_SVC_PS_OFF,
+	VCONFKEY_TELEPHONY_SVC_PS_ON
+};
+
+enum {
+	VCONFKEY_TELEPHONY_SVC_ROAM_OFF,
+	VCONFKEY_TELEPHONY_SVC_ROAM_ON
+};
+
+enum {
+	VCONFKEY_TELEPHONY_ZONE_NONE
+};
+
+enum {
+	VCONFKEY_TELEPHONY_SIM_INIT_NONE,
+	VCONFKEY_TELEPHONY_SIM_INIT_COMPLETED
+};
+
+enum {
+	VCONFKEY_TELEPHONY_SIM_UNKNOWN = -1,
+	VCONFKEY_TELEPHONY_SIM_INSERTED = 1,
+	VCONFKEY_TELEPHONY_SIM_NOT_PRESENT,
+	VCONFKEY_TELEPHONY_SIM_CARD_ERROR
+};
+
+enum {
+	VCONFKEY_TELEPHONY_SIM_PB_INIT_NONE
+};
+
+enum {
+	VCONFKEY_TELEPHONY_CALL_CONNECT_IDLE
+};
+
+enum {
+	VCONFKEY_TELEPHONY_CALL_FORWARD_OFF
+};
+
+enum {
+	VCONFKEY_TELEPHONY_TAPI_STATE_NONE = -1,
+	VCONFKEY_TELEPHONY_TAPI_STATE_READY = 0
+};
+
+enum {
+	VCONFKEY_TELEPHONY_DISP_INVALID,
+	VCONFKEY_TELEPHONY_DISP_SPN,
+	VCONFKEY_TELEPHONY_DISP_PLMN,
+	VCONFKEY_TELEPHONY_DISP_SPN_PLMN
+};
+
+enum {
+	VCONFKEY_TELEPHONY_SAT_NONE
+};
+
+enum {
+	VCONFKEY_TELEPHONY_RSSI_0
+};
+
+enum {
+	VCONFKEY_TELEPHONY_BATT_NORMAL_LEVEL = 3
+};
+
+enum {
+	VCONFKEY_TELEPHONY_PSTYPE_NONE,
+	VCONFKEY_TELEPHONY_PSTYPE_HSDPA,
+	VCONFKEY_TELEPHONY_PSTYPE_HSUPA,
+	VCONFKEY_TELEPHONY_PSTYPE_HSPA
+};
+
+enum {
+	VCONFKEY_PM_STATE_NORMAL = 1,
+	VCONFKEY_PM_STATE_LCDDIM,
+	VCONFKEY_PM_STATE_LCDOFF,
+	VCONFKEY_PM_STATE_SLEEP
+};
+
+#endif
@@ -0,0 +1,308 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * tel-vconf-load: notification load generator for vconf-plugin
+ *
+ * usage: tel-vconf-load [seconds] [modems]
+ *
+ * Drives the plugin's notification hooks with the mixes a device sees
+ * under stress, each for the given time (default 2 s), from one or more
+ * modem network objects (default 1). The main loop gets one
+ * non-blocking iteration after every notification, as it would between
+ * two modem messages. Each mix reports the sustained notification rate,
+ * the p50/p99 time spent in the hooks of one notification, the vconf
+ * key writes per notification and the process peak RSS so far.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+#include <vconf.h>
+
+#include <tcore.h>
+#include <server.h>
+#include <plugin.h>
+#include <storage.h>
+#include <co_network.h>
+
+#include "vconf-fake.h"
+#include "tcore-fake.h"
+#include "bench.h"
+
+#define LOAD_SECONDS 2
+#define LOAD_MODEMS_MAX 4
+#define LOAD_SAMPLES_MAX (1 << 22)
+
+struct load_ctx {
+	struct bench_env *env;
+	CoreObject *networks[LOAD_MODEMS_MAX];
+	TcorePlugin *modems[LOAD_MODEMS_MAX];
+	guint modem_count;
+	CoreObject *source;		/* network of the current step */
+	guint32 *samples;		/* hook latencies, ns */
+	guint sample_count;
+	guint64 notifications;
+};
+
+/* one step of a mix; sends one or more notifications through notify() */
+typedef void (*LoadStep)(struct load_ctx *ctx, guint i);
+
+struct load_mix {
+	const char *name;
+	LoadStep step;
+};
+
+static void notify(struct load_ctx *ctx, enum tcore_notification_command command, unsigned int data_len, void *data)
+{
+	gint64 t0 = bench_now_ns();
+
+	tcore_server_send_notification(ctx->env->server, ctx->source, command, data_len, data);
+
+	if (ctx->sample_count < LOAD_SAMPLES_MAX)
+		ctx->samples[ctx->sample_count++] = (guint32)MIN(bench_now_ns() - t0, G_MAXUINT32);
+	ctx->notifications++;
+
+	g_main_context_iteration(NULL, FALSE);
+}
+
+static void send_cellinfo(struct load_ctx *ctx, guint lac, guint cell_id)
+{
+	struct tnoti_network_location_cellinfo info = { lac, cell_id };
+
+	notify(ctx, TNOTI_NETWORK_LOCATION_CELLINFO, sizeof(info), &info);
+}
+
+static void send_rssi(struct load_ctx *ctx, int rssi)
+{
+	struct tnoti_network_icon_info info = { 0, rssi, 0, 0 };
+
+	notify(ctx, TNOTI_NETWORK_ICON_INFO, sizeof(info), &info);
+}
+
+static void send_registration(struct load_ctx *ctx, enum telephony_network_service_domain_status status,
+		enum telephony_network_service_type type)
+{
+	struct tnoti_network_registration_status info;
+
+	info.cs_domain_status = status;
+	info.ps_domain_status = status;
+	info.service_type = type;
+	info.roaming_status = 0;
+
+	notify(ctx, TNOTI_NETWORK_REGISTRATION_STATUS, sizeof(info), &info);
+}
+
+static void send_network_change(struct load_ctx *ctx, const char *plmn, guint lac)
+{
+	struct tnoti_network_change info;
+
+	memset(&info, 0, sizeof(info));
+	snprintf(info.plmn, sizeof(info.plmn), "%s", plmn);
+	info.gsm.lac = lac;
+	tcore_fake_network_set_plmn(ctx->source, plmn);
+
+	notify(ctx, TNOTI_NETWORK_CHANGE, sizeof(info), &info);
+}
+
+static void send_sim_status(struct load_ctx *ctx, enum tel_sim_status status)
+{
+	struct tnoti_sim_status info = { status, 1 };
+
+	notify(ctx, TNOTI_SIM_STATUS, sizeof(info), &info);
+}
+
+static void send_phonebook(struct load_ctx *ctx, gboolean init)
+{
+	struct tnoti_phonebook_status info = { init };
+
+	notify(ctx, TNOTI_PHONEBOOK_STATUS, sizeof(info), &info);
+}
+
+static void send_modem_power(struct load_ctx *ctx, enum modem_state state)
+{
+	struct tnoti_modem_power info = { state };
+
+	notify(ctx, TNOTI_MODEM_POWER, sizeof(info), &info);
+}
+
+/* cell change, mostly within the PLMN, every 8th to a neighbour network */
+static void step_handover(struct load_ctx *ctx, guint i)
+{
+	guint lac = 0x1000 + (i & 7);
+
+	send_cellinfo(ctx, lac, 0x20000 + (i & 0xff));
+	send_network_change(ctx, i & 8 ? "45005" : "45001", lac);
+	send_registration(ctx, NETWORK_SERVICE_DOMAIN_STATUS_FULL,
+			i & 1 ? NETWORK_SERVICE_TYPE_3G : NETWORK_SERVICE_TYPE_HSDPA);
+}
+
+/* a fading signal: the level wanders up and down, often unchanged */
+static void step_rssi_flood(struct load_ctx *ctx, guint i)
+{
+	static const int levels[] = { 4, 4, 3, 3, 2, 3, 4, 5, 5, 6, 5, 4 };
+
+	send_rssi(ctx, levels[i % G_N_ELEMENTS(levels)]);
+}
+
+static void step_sim_hot_swap(struct load_ctx *ctx, guint i)
+{
+	send_sim_status(ctx, SIM_STATUS_CARD_REMOVED);
+	send_phonebook(ctx, FALSE);
+	send_sim_status(ctx, SIM_STATUS_INITIALIZING);
+	send_sim_status(ctx, i & 1 ? SIM_STATUS_PIN_REQUIRED : SIM_STATUS_INIT_COMPLETED);
+	if (i & 1)
+		send_sim_status(ctx, SIM_STATUS_INIT_COMPLETED);
+	send_phonebook(ctx, TRUE);
+}
+
+/* modem reset: error, out of service, back online and registered again */
+static void step_cp_crash(struct load_ctx *ctx, guint i)
+{
+	send_modem_power(ctx, MODEM_STATE_ERROR);
+	send_registration(ctx, NETWORK_SERVICE_DOMAIN_STATUS_NO, NETWORK_SERVICE_TYPE_NO_SERVICE);
+	send_modem_power(ctx, MODEM_STATE_ONLINE);
+	send_network_change(ctx, "45001", 0x1000);
+	send_registration(ctx, NETWORK_SERVICE_DOMAIN_STATUS_FULL, NETWORK_SERVICE_TYPE_3G);
+	send_cellinfo(ctx, 0x1000, 0x20000 + (i & 0xff));
+}
+
+/* the other mixes interleaved, RSSI updates dominating */
+static void step_mixed(struct load_ctx *ctx, guint i)
+{
+	switch (i % 64) {
+	case 0:
+		step_cp_crash(ctx, i);
+		break;
+	case 16:
+		step_sim_hot_swap(ctx, i);
+		break;
+	case 8: case 24: case 40: case 56:
+		step_handover(ctx, i);
+		break;
+	default:
+		step_rssi_flood(ctx, i);
+		break;
+	}
+}
+
+static const struct load_mix mixes[] = {
+	{ "handover burst", step_handover },
+	{ "rssi flood", step_rssi_flood },
+	{ "sim hot-swap", step_sim_hot_swap },
+	{ "cp crash loop", step_cp_crash },
+	{ "mixed", step_mixed },
+};
+
+static int sample_cmp(const void *a, const void *b)
+{
+	guint32 x = *(const guint32 *)a, y = *(const guint32 *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+static guint32 percentile(const guint32 *sorted, guint count, guint pct)
+{
+	if (!count)
+		return 0;
+
+	return sorted[MIN((guint64)count * pct / 100, count - 1)];
+}
+
+static void run_mix(struct load_ctx *ctx, const struct load_mix *mix, guint seconds)
+{
+	struct vconf_fake_stats stats;
+	gint64 start, end, elapsed;
+	guint i;
+
+	ctx->sample_count = 0;
+	ctx->notifications = 0;
+	bench_env_settle();
+	vconf_fake_clear_stats();
+
+	start = bench_now_ns();
+	end = start + (gint64)seconds * G_GINT64_CONSTANT(1000000000);
+
+	for (i = 0; ; i++) {
+		ctx->source = ctx->networks[i % ctx->modem_count];
+		mix->step(ctx, i);
+
+		if ((i & 63) == 0 && bench_now_ns() >= end)
+			break;
+	}
+
+	/* the writes still queued belong to this mix */
+	bench_env_settle();
+	elapsed = bench_now_ns() - start;
+	vconf_fake_get_stats(&stats);
+
+	qsort(ctx->samples, ctx->sample_count, sizeof(ctx->samples[0]), sample_cmp);
+
+	printf("%-20s %12.0f %10u %10u %12.2f %10ld\n", mix->name,
+			ctx->notifications * 1e9 / elapsed,
+			percentile(ctx->samples, ctx->sample_count, 50),
+			percentile(ctx->samples, ctx->sample_count, 99),
+			(double)stats.writes / MAX(ctx->notifications, 1),
+			bench_peak_rss());
+}
+
+int main(int argc, char *argv[])
+{
+	struct bench_env env;
+	struct load_ctx ctx;
+	guint seconds = LOAD_SECONDS;
+	guint i;
+
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.modem_count = 1;
+
+	if (argc > 1)
+		seconds = MAX(atoi(argv[1]), 1);
+	if (argc > 2)
+		ctx.modem_count = CLAMP(atoi(argv[2]), 1, LOAD_MODEMS_MAX);
+
+	bench_env_start(&env, NULL);
+	ctx.env = &env;
+	ctx.networks[0] = env.network;
+	for (i = 1; i < ctx.modem_count; i++) {
+		ctx.modems[i] = tcore_plugin_new(env.server, NULL, "modem", NULL);
+		ctx.networks[i] = tcore_fake_network_new(ctx.modems[i]);
+		tcore_fake_network_set_plmn(ctx.networks[i], "45001");
+		tcore_fake_network_set_service_type(ctx.networks[i], NETWORK_SERVICE_TYPE_3G);
+	}
+	ctx.samples = g_new(guint32, LOAD_SAMPLES_MAX);
+
+	printf("%u s per mix, %u modem(s)\n\n", seconds, ctx.modem_count);
+	printf("%-20s %12s %10s %10s %12s %10s\n", "", "notif/s", "p50 ns", "p99 ns", "writes/notif", "peak KiB");
+
+	for (i = 0; i < G_N_ELEMENTS(mixes); i++)
+		run_mix(&ctx, &mixes[i], seconds);
+
+	for (i = 1; i < ctx.modem_count; i++) {
+		tcore_fake_network_free(ctx.networks[i]);
+		tcore_plugin_free(ctx.modems[i]);
+	}
+	g_free(ctx.samples);
+	bench_env_stop(&env);
+
+	return 0;
+}
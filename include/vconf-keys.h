@@ -0,0 +1,157 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VCONF_KEYS_H__
+#define __VCONF_KEYS_H__
+
+/*
+ * Storage key table
+ *
+ * X(id, storage key, vconf key)
+ *
+ * Every lookup between tcore storage keys and vconf key names is expanded
+ * from this list, so a new key only needs to be added here. The value type
+ * follows the STORAGE_KEY_INT/BOOL/STRING bits of the storage key.
+ */
+#define VCONF_STORAGE_KEYS(X) \
+	X(PLMN, STORAGE_KEY_TELEPHONY_PLMN, VCONFKEY_TELEPHONY_PLMN) \
+	X(LAC, STORAGE_KEY_TELEPHONY_LAC, VCONFKEY_TELEPHONY_LAC) \
+	X(CELLID, STORAGE_KEY_TELEPHONY_CELLID, VCONFKEY_TELEPHONY_CELLID) \
+	X(SVCTYPE, STORAGE_KEY_TELEPHONY_SVCTYPE, VCONFKEY_TELEPHONY_SVCTYPE) \
+	X(SVC_CS, STORAGE_KEY_TELEPHONY_SVC_CS, VCONFKEY_TELEPHONY_SVC_CS) \
+	X(SVC_PS, STORAGE_KEY_TELEPHONY_SVC_PS, VCONFKEY_TELEPHONY_SVC_PS) \
+	X(SVC_ROAM, STORAGE_KEY_TELEPHONY_SVC_ROAM, VCONFKEY_TELEPHONY_SVC_ROAM) \
+	X(ZONE_TYPE, STORAGE_KEY_TELEPHONY_ZONE_TYPE, VCONFKEY_TELEPHONY_ZONE_TYPE) \
+	X(SIM_INIT, STORAGE_KEY_TELEPHONY_SIM_INIT, VCONFKEY_TELEPHONY_SIM_INIT) \
+	X(SIM_CHV, STORAGE_KEY_TELEPHONY_SIM_CHV, VCONFKEY_TELEPHONY_SIM_CHV) \
+	X(SIM_PB_INIT, STORAGE_KEY_TELEPHONY_SIM_PB_INIT, VCONFKEY_TELEPHONY_SIM_PB_INIT) \
+	X(CALL_STATE, STORAGE_KEY_TELEPHONY_CALL_STATE, VCONFKEY_TELEPHONY_CALL_STATE) \
+	X(CALL_FORWARD_STATE, STORAGE_KEY_TELEPHONY_CALL_FORWARD_STATE, VCONFKEY_TELEPHONY_CALL_FORWARD_STATE) \
+	X(TAPI_STATE, STORAGE_KEY_TELEPHONY_TAPI_STATE, VCONFKEY_TELEPHONY_TAPI_STATE) \
+	X(SPN_DISP_CONDITION, STORAGE_KEY_TELEPHONY_SPN_DISP_CONDITION, VCONFKEY_TELEPHONY_SPN_DISP_CONDITION) \
+	X(SAT_STATE, STORAGE_KEY_TELEPHONY_SAT_STATE, VCONFKEY_TELEPHONY_SAT_STATE) \
+	X(ZONE_ZUHAUSE, STORAGE_KEY_TELEPHONY_ZONE_ZUHAUSE, VCONFKEY_TELEPHONY_ZONE_ZUHAUSE) \
+	X(RSSI, STORAGE_KEY_TELEPHONY_RSSI, VCONFKEY_TELEPHONY_RSSI) \
+	X(LOW_BATTERY, STORAGE_KEY_TELEPHONY_LOW_BATTERY, VCONFKEY_TELEPHONY_LOW_BATTERY) \
+	X(EVENT_SYSTEM_READY, STORAGE_KEY_TELEPHONY_EVENT_SYSTEM_READY, "memory/telephony/event_system_ready") \
+	X(READY, STORAGE_KEY_TELEPHONY_READY, VCONFKEY_TELEPHONY_READY) \
+	X(SIM_SLOT, STORAGE_KEY_TELEPHONY_SIM_SLOT, VCONFKEY_TELEPHONY_SIM_SLOT) \
+	X(PM_STATE, STORAGE_KEY_PM_STATE, VCONFKEY_PM_STATE) \
+	X(PACKET_SERVICE_STATE, STORAGE_KEY_PACKET_SERVICE_STATE, VCONFKEY_DNET_STATE) \
+	X(MESSAGE_NETWORK_MODE, STORAGE_KEY_MESSAGE_NETWORK_MODE, VCONFKEY_MESSAGE_NETWORK_MODE) \
+	X(3G_ENABLE, STORAGE_KEY_3G_ENABLE, VCONFKEY_3G_ENABLE) \
+	X(DATA_ROAMING, STORAGE_KEY_SETAPPL_STATE_DATA_ROAMING_BOOL, VCONFKEY_SETAPPL_STATE_DATA_ROAMING_BOOL) \
+	X(AUTOMATIC_TIME_UPDATE, STORAGE_KEY_SETAPPL_STATE_AUTOMATIC_TIME_UPDATE_BOOL, VCONFKEY_SETAPPL_STATE_AUTOMATIC_TIME_UPDATE_BOOL) \
+	X(FLIGHT_MODE, STORAGE_KEY_SETAPPL_FLIGHT_MODE_BOOL, VCONFKEY_SETAPPL_FLIGHT_MODE_BOOL) \
+	X(NWNAME, STORAGE_KEY_TELEPHONY_NWNAME, VCONFKEY_TELEPHONY_NWNAME) \
+	X(SPN_NAME, STORAGE_KEY_TELEPHONY_SPN_NAME, VCONFKEY_TELEPHONY_SPN_NAME) \
+	X(SAT_SETUP_IDLE_TEXT, STORAGE_KEY_TELEPHONY_SAT_SETUP_IDLE_TEXT, VCONFKEY_TELEPHONY_SAT_SETUP_IDLE_TEXT) \
+	X(IMEI, STORAGE_KEY_TELEPHONY_IMEI, VCONFKEY_TELEPHONY_IMEI) \
+	X(SUBSCRIBER_NUMBER, STORAGE_KEY_TELEPHONY_SUBSCRIBER_NUMBER, VCONFKEY_TELEPHONY_SUBSCRIBER_NUMBER) \
+	X(SUBSCRIBER_NAME, STORAGE_KEY_TELEPHONY_SUBSCRIBER_NAME, VCONFKEY_TELEPHONY_SUBSCRIBER_NAME) \
+	X(SWVERSION, STORAGE_KEY_TELEPHONY_SWVERSION, VCONFKEY_TELEPHONY_SWVERSION) \
+	X(HWVERSION, STORAGE_KEY_TELEPHONY_HWVERSION, VCONFKEY_TELEPHONY_HWVERSION) \
+	X(CALDATE, STORAGE_KEY_TELEPHONY_CALDATE, VCONFKEY_TELEPHONY_CALDATE) \
+	X(IMEI_FACTORY_REBOOT, STORAGE_KEY_TELEPHONY_IMEI_FACTORY_REBOOT, VCONFKEY_TELEPHONY_IMEI_FACTORY_REBOOT) \
+	X(SIM_FACTORY_MODE, STORAGE_KEY_TELEPHONY_SIM_FACTORY_MODE, VCONFKEY_TELEPHONY_SIM_FACTORY_MODE) \
+	X(PRODUCTCODE, STORAGE_KEY_TELEPHONY_PRODUCTCODE, VCONFKEY_TELEPHONY_PRODUCTCODE) \
+	X(FACTORY_KSTRINGB, STORAGE_KEY_TELEPHONY_FACTORY_KSTRINGB, VCONFKEY_TELEPHONY_FACTORY_KSTRINGB) \
+	X(IMSI, STORAGE_KEY_TELEPHONY_IMSI, "db/private/tel-plugin-vconf/imsi") \
+	X(CELLULAR_STATE, STORAGE_KEY_CELLULAR_STATE, VCONFKEY_NETWORK_CELLULAR_STATE) \
+	X(CELLULAR_PKT_TOTAL_RCV, STORAGE_KEY_CELLULAR_PKT_TOTAL_RCV, VCONFKEY_NETWORK_CELLULAR_PKT_TOTAL_RCV) \
+	X(CELLULAR_PKT_TOTAL_SNT, STORAGE_KEY_CELLULAR_PKT_TOTAL_SNT, VCONFKEY_NETWORK_CELLULAR_PKT_TOTAL_SNT) \
+	X(CELLULAR_PKT_LAST_RCV, STORAGE_KEY_CELLULAR_PKT_LAST_RCV, VCONFKEY_NETWORK_CELLULAR_PKT_LAST_RCV) \
+	X(CELLULAR_PKT_LAST_SNT, STORAGE_KEY_CELLULAR_PKT_LAST_SNT, VCONFKEY_NETWORK_CELLULAR_PKT_LAST_SNT)
+
+/* full 64-bit packet counters, "total_rcv total_snt last_rcv last_snt" */
+#define VCONFKEY_TEL_PLUGIN_PKT_COUNTERS "db/private/tel-plugin-vconf/pkt_counters"
+
+/*
+ * Keys written by the plugin that have no tcore storage key
+ *
+ * X(id, vconf key, vconf type)
+ */
+#define VCONF_PLUGIN_KEYS(X) \
+	X(PSTYPE, VCONFKEY_TELEPHONY_PSTYPE, VCONF_TYPE_INT) \
+	X(PKT_COUNTERS, VCONFKEY_TEL_PLUGIN_PKT_COUNTERS, VCONF_TYPE_STRING)
+
+/*
+ * Write priority of a key
+ *
+ * X(id, class)
+ *
+ * Unlisted keys are NORMAL. CRITICAL keys skip the rate-limit policy and
+ * the write-behind queue. LOW keys are held and coalesced until the main
+ * loop is idle; the packet counters are already deferred by their own
+ * accumulator. Keys that must be seen together (PLMN, LAC, CELLID) have
+ * to share a class, or one of them is published a batch later.
+ */
+enum vconf_key_prio {
+	VKEY_PRIO_NORMAL,
+	VKEY_PRIO_CRITICAL,
+	VKEY_PRIO_LOW,
+};
+
+#define VCONF_KEY_PRIORITIES(X) \
+	X(CALL_STATE, CRITICAL) \
+	X(SIM_SLOT, CRITICAL) \
+	X(SIM_INIT, CRITICAL) \
+	X(SIM_CHV, CRITICAL) \
+	X(TAPI_STATE, CRITICAL) \
+	X(READY, CRITICAL) \
+	X(RSSI, LOW) \
+	X(CELLULAR_PKT_TOTAL_RCV, LOW) \
+	X(CELLULAR_PKT_TOTAL_SNT, LOW) \
+	X(CELLULAR_PKT_LAST_RCV, LOW) \
+	X(CELLULAR_PKT_LAST_SNT, LOW)
+
+/*
+ * Keys holding device or subscriber identifiers. They are only served
+ * through vconf, whose access control applies, and never mirrored into
+ * the world-mappable shared-memory region.
+ *
+ * X(id)
+ */
+#define VCONF_PRIVATE_KEYS(X) \
+	X(IMEI) \
+	X(SUBSCRIBER_NUMBER) \
+	X(SUBSCRIBER_NAME) \
+	X(IMSI)
+
+#define VCONF_KEY_TYPE(strg_key) \
+	(((strg_key) & STORAGE_KEY_STRING) ? VCONF_TYPE_STRING : \
+	 ((strg_key) & STORAGE_KEY_BOOL) ? VCONF_TYPE_BOOL : VCONF_TYPE_INT)
+
+#define VCONF_KEY_ID(id, strg_key, name) VKEY_##id,
+#define VCONF_PLUGIN_KEY_ID(id, name, type) VKEY_##id,
+
+enum vconf_key_id {
+	VCONF_STORAGE_KEYS(VCONF_KEY_ID)
+	VCONF_PLUGIN_KEYS(VCONF_PLUGIN_KEY_ID)
+	VKEY_MAX
+};
+
+struct vconf_key_desc {
+	enum tcore_storage_key strg_key;
+	const char *name;
+	int type;
+};
+
+#endif
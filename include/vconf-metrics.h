@@ -0,0 +1,42 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VCONF_METRICS_H__
+#define __VCONF_METRICS_H__
+
+/*
+ * Latency histogram with power-of-two microsecond buckets:
+ * bucket 0 holds < 1us, bucket n holds [2^(n-1), 2^n) us and the last
+ * bucket everything above.
+ */
+#define VCONF_HISTOGRAM_BUCKETS 20
+
+struct vconf_histogram {
+	guint count;
+	guint64 total_us;
+	guint max_us;
+	guint buckets[VCONF_HISTOGRAM_BUCKETS];
+};
+
+void vconf_histogram_add(struct vconf_histogram *h, gint64 us);
+guint vconf_histogram_percentile(const struct vconf_histogram *h, guint pct);
+void vconf_histogram_dump(const struct vconf_histogram *h, const char *name, GString *out, gboolean json);
+
+#endif
@@ -0,0 +1,83 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VCONF_OPERATOR_H__
+#define __VCONF_OPERATOR_H__
+
+/*
+ * Read-only operator name index (mmap'd file)
+ *
+ * header | entries[count] sorted by key | string pool
+ *
+ * The key packs MCC and MNC into one integer, keeping 2- and 3-digit
+ * MNCs apart ("01" and "001" are different networks). Offsets point
+ * into the NUL-terminated string pool. Files are built by
+ * tel-vconf-operator-index; without a file the plugin builds the same
+ * layout in memory from tcore's operator database.
+ */
+#define VCONF_OPERATOR_INDEX_PATH "/usr/share/tel-plugin-vconf/operators.idx"
+#define VCONF_OPERATOR_INDEX_MAGIC "TVOPIDX1"
+#define VCONF_OPERATOR_INDEX_VERSION 1
+#define VCONF_OPERATOR_KEY_INVALID 0xFFFFFFFFu
+
+/* mcc_mnc_oper_list, the table tcore's network operator info is loaded from */
+#define VCONF_OPERATOR_DB_PATH "/opt/dbspace/.mcc_mnc_oper_list.db"
+#define VCONF_OPERATOR_DB_QUERY "select country, mcc, mnc, oper from mcc_mnc_oper_list"
+
+struct vconf_operator_index_header {
+	char magic[8];
+	guint32 version;
+	guint32 count;
+	guint32 strings_size;
+	guint32 reserved;
+};
+
+struct vconf_operator_index_entry {
+	guint32 key;
+	guint32 name;		/* string pool offsets */
+	guint32 country;
+};
+
+struct vconf_operator_row {
+	const char *mcc;
+	const char *mnc;
+	const char *country;
+	const char *name;
+};
+
+/* VCONF_OPERATOR_KEY_INVALID unless mcc has 3 and mnc 2 or 3 digits */
+guint32 vconf_operator_key(const char *mcc, const char *mnc);
+
+/*
+ * Index image of rows, skipping rows with an invalid MCC/MNC; for a
+ * repeated MCC/MNC the first row wins. Release with g_free().
+ */
+gchar *vconf_operator_index_build(const struct vconf_operator_row *rows, guint count, gsize *size);
+
+gboolean vconf_operator_index_open(const char *path);
+/* takes ownership of data (g_malloc()ed) on success */
+gboolean vconf_operator_index_load(gchar *data, gsize size);
+gboolean vconf_operator_index_loaded(void);
+void vconf_operator_index_close(void);
+
+/* operator name, pointing into the mapping; NULL when not indexed */
+const char *vconf_operator_index_find(const char *mcc, const char *mnc, const char **country);
+
+#endif
@@ -0,0 +1,65 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VCONF_RADIO_H__
+#define __VCONF_RADIO_H__
+
+/*
+ * Radio history: the last changes of RSSI, CELLID, LAC, SVCTYPE and
+ * PSTYPE as timestamped 16-byte records in a fixed-size ring. The oldest
+ * record is overwritten once the ring is full.
+ */
+enum vconf_radio_field {
+	VCONF_RADIO_RSSI,
+	VCONF_RADIO_CELLID,
+	VCONF_RADIO_LAC,
+	VCONF_RADIO_SVCTYPE,
+	VCONF_RADIO_PSTYPE,
+	VCONF_RADIO_FIELD_MAX
+};
+
+struct vconf_radio_record {
+	gint64 time;		/* g_get_monotonic_time(), us */
+	guint32 field;		/* enum vconf_radio_field */
+	gint32 value;
+};
+
+/* capacity is rounded up to a power of two */
+gboolean vconf_radio_init(guint capacity);
+void vconf_radio_free(void);
+
+/* records value only when it differs from the field's last record */
+void vconf_radio_record(enum vconf_radio_field field, gint32 value);
+
+/*
+ * Copies the records with from <= time < to, oldest first, into out and
+ * returns how many were copied (at most max). to <= 0 means no limit.
+ */
+guint vconf_radio_snapshot(gint64 from, gint64 to, struct vconf_radio_record *out, guint max);
+
+/*
+ * Whole history as JSON for other processes, e.g.
+ * {"now":123,"records":[{"time":100,"field":"rssi","value":4},...]}
+ * Times are CLOCK_MONOTONIC in us, which is system-wide, so a reader can
+ * compare them with its own g_get_monotonic_time().
+ */
+gchar *vconf_radio_export(void);
+
+#endif
@@ -0,0 +1,99 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VCONF_SCHEMA_H__
+#define __VCONF_SCHEMA_H__
+
+/*
+ * Default value and install flags of every vconf key owned by the package
+ *
+ * X(vconf key, vconf type, int/bool default, string default, flags)
+ *
+ * tel-vconf-provision creates the keys from this list at install time and
+ * reset_vconf() writes the VCONF_SCHEMA_RESET entries when the plugin
+ * starts, so both always agree on the defaults.
+ */
+#define VCONF_SCHEMA_INSTALL	0x01	/* memory key recreated at boot (vconftool -i) */
+#define VCONF_SCHEMA_FORCE	0x02	/* overwrite an existing value (vconftool -f) */
+#define VCONF_SCHEMA_RESET	0x04	/* written by reset_vconf() */
+#define VCONF_SCHEMA_WARM	0x08	/* kept across a warm restart, see desc-vconf.c */
+
+#define VCONF_SCHEMA_DEFAULT	(VCONF_SCHEMA_INSTALL | VCONF_SCHEMA_FORCE)
+#define VCONF_SCHEMA_VOLATILE	(VCONF_SCHEMA_DEFAULT | VCONF_SCHEMA_RESET)
+#define VCONF_SCHEMA_DISPLAY	(VCONF_SCHEMA_VOLATILE | VCONF_SCHEMA_WARM)
+
+#define VCONF_SCHEMA(X) \
+	X(VCONFKEY_NETWORK_CELLULAR_PKT_TOTAL_SNT, VCONF_TYPE_INT, 0, NULL, VCONF_SCHEMA_DEFAULT) \
+	X(VCONFKEY_NETWORK_CELLULAR_PKT_TOTAL_RCV, VCONF_TYPE_INT, 0, NULL, VCONF_SCHEMA_DEFAULT) \
+	X(VCONFKEY_NETWORK_CELLULAR_PKT_LAST_SNT, VCONF_TYPE_INT, 0, NULL, VCONF_SCHEMA_DEFAULT) \
+	X(VCONFKEY_NETWORK_CELLULAR_PKT_LAST_RCV, VCONF_TYPE_INT, 0, NULL, VCONF_SCHEMA_DEFAULT) \
+	X(VCONFKEY_DNET_STATE, VCONF_TYPE_INT, 0, NULL, VCONF_SCHEMA_INSTALL) \
+	X(VCONFKEY_NETWORK_CELLULAR_STATE, VCONF_TYPE_INT, 4, NULL, VCONF_SCHEMA_INSTALL) \
+	X(VCONFKEY_TELEPHONY_PSTYPE, VCONF_TYPE_INT, 0, NULL, VCONF_SCHEMA_DEFAULT) \
+	X("memory/telephony/event_system_ready", VCONF_TYPE_INT, 0, NULL, VCONF_SCHEMA_DEFAULT) \
+	X(VCONFKEY_TELEPHONY_NWNAME, VCONF_TYPE_STRING, 0, "", VCONF_SCHEMA_DISPLAY) \
+	X(VCONFKEY_TELEPHONY_PLMN, VCONF_TYPE_INT, 0, NULL, VCONF_SCHEMA_DISPLAY) \
+	X(VCONFKEY_TELEPHONY_LAC, VCONF_TYPE_INT, 0, NULL, VCONF_SCHEMA_DISPLAY) \
+	X(VCONFKEY_TELEPHONY_CELLID, VCONF_TYPE_INT, 0, NULL, VCONF_SCHEMA_DISPLAY) \
+	X(VCONFKEY_TELEPHONY_SVCTYPE, VCONF_TYPE_INT, VCONFKEY_TELEPHONY_SVCTYPE_NONE, NULL, VCONF_SCHEMA_DISPLAY) \
+	X(VCONFKEY_TELEPHONY_SVC_CS, VCONF_TYPE_INT, VCONFKEY_TELEPHONY_SVC_CS_UNKNOWN, NULL, VCONF_SCHEMA_DISPLAY) \
+	X(VCONFKEY_TELEPHONY_SVC_PS, VCONF_TYPE_INT, VCONFKEY_TELEPHONY_SVC_PS_UNKNOWN, NULL, VCONF_SCHEMA_DISPLAY) \
+	X(VCONFKEY_TELEPHONY_SVC_ROAM, VCONF_TYPE_INT, VCONFKEY_TELEPHONY_SVC_ROAM_OFF, NULL, VCONF_SCHEMA_DISPLAY) \
+	X(VCONFKEY_TELEPHONY_ZONE_TYPE, VCONF_TYPE_INT, VCONFKEY_TELEPHONY_ZONE_NONE, NULL, VCONF_SCHEMA_VOLATILE) \
+	X(VCONFKEY_TELEPHONY_SIM_INIT, VCONF_TYPE_INT, VCONFKEY_TELEPHONY_SIM_INIT_NONE, NULL, VCONF_SCHEMA_VOLATILE) \
+	X(VCONFKEY_TELEPHONY_SIM_CHV, VCONF_TYPE_INT, 0xFF, NULL, VCONF_SCHEMA_VOLATILE) \
+	X(VCONFKEY_TELEPHONY_SIM_SLOT, VCONF_TYPE_INT, VCONFKEY_TELEPHONY_SIM_UNKNOWN, NULL, VCONF_SCHEMA_DISPLAY) \
+	X(VCONFKEY_TELEPHONY_SIM_PB_INIT, VCONF_TYPE_INT, VCONFKEY_TELEPHONY_SIM_PB_INIT_NONE, NULL, VCONF_SCHEMA_VOLATILE) \
+	X(VCONFKEY_TELEPHONY_CALL_STATE, VCONF_TYPE_INT, VCONFKEY_TELEPHONY_CALL_CONNECT_IDLE, NULL, VCONF_SCHEMA_VOLATILE) \
+	X(VCONFKEY_TELEPHONY_CALL_FORWARD_STATE, VCONF_TYPE_INT, VCONFKEY_TELEPHONY_CALL_FORWARD_OFF, NULL, VCONF_SCHEMA_VOLATILE) \
+	X(VCONFKEY_TELEPHONY_TAPI_STATE, VCONF_TYPE_INT, VCONFKEY_TELEPHONY_TAPI_STATE_NONE, NULL, VCONF_SCHEMA_VOLATILE) \
+	X(VCONFKEY_TELEPHONY_SPN_DISP_CONDITION, VCONF_TYPE_INT, VCONFKEY_TELEPHONY_DISP_INVALID, NULL, VCONF_SCHEMA_DISPLAY) \
+	X(VCONFKEY_TELEPHONY_SPN_NAME, VCONF_TYPE_STRING, 0, "", VCONF_SCHEMA_DISPLAY) \
+	X("memory/telephony/sat_idle", VCONF_TYPE_INT, 0, NULL, VCONF_SCHEMA_DEFAULT) \
+	X(VCONFKEY_TELEPHONY_SAT_STATE, VCONF_TYPE_INT, VCONFKEY_TELEPHONY_SAT_NONE, NULL, VCONF_SCHEMA_VOLATILE) \
+	X(VCONFKEY_TELEPHONY_SAT_SETUP_IDLE_TEXT, VCONF_TYPE_STRING, 0, "", VCONF_SCHEMA_VOLATILE) \
+	X(VCONFKEY_TELEPHONY_ZONE_ZUHAUSE, VCONF_TYPE_INT, 0, NULL, VCONF_SCHEMA_VOLATILE) \
+	X(VCONFKEY_TELEPHONY_RSSI, VCONF_TYPE_INT, VCONFKEY_TELEPHONY_RSSI_0, NULL, VCONF_SCHEMA_DISPLAY) \
+	X(VCONFKEY_TELEPHONY_LOW_BATTERY, VCONF_TYPE_INT, VCONFKEY_TELEPHONY_BATT_NORMAL_LEVEL, NULL, VCONF_SCHEMA_VOLATILE) \
+	X(VCONFKEY_TELEPHONY_IMEI, VCONF_TYPE_STRING, 0, "deprecated_vconf_imei", VCONF_SCHEMA_VOLATILE) \
+	X(VCONFKEY_TELEPHONY_SUBSCRIBER_NUMBER, VCONF_TYPE_STRING, 0, "", VCONF_SCHEMA_VOLATILE) \
+	X(VCONFKEY_TELEPHONY_SUBSCRIBER_NAME, VCONF_TYPE_STRING, 0, "", VCONF_SCHEMA_VOLATILE) \
+	X(VCONFKEY_TELEPHONY_SWVERSION, VCONF_TYPE_STRING, 0, "", VCONF_SCHEMA_DEFAULT) \
+	X(VCONFKEY_TELEPHONY_HWVERSION, VCONF_TYPE_STRING, 0, "", VCONF_SCHEMA_DEFAULT) \
+	X(VCONFKEY_TELEPHONY_CALDATE, VCONF_TYPE_STRING, 0, "", VCONF_SCHEMA_DEFAULT) \
+	X(VCONFKEY_TELEPHONY_PRODUCTCODE, VCONF_TYPE_STRING, 0, "", VCONF_SCHEMA_DEFAULT) \
+	X(VCONFKEY_TELEPHONY_READY, VCONF_TYPE_BOOL, FALSE, NULL, VCONF_SCHEMA_VOLATILE) \
+	X("db/private/tel-plugin-vconf/imsi", VCONF_TYPE_STRING, 0, "", VCONF_SCHEMA_FORCE) \
+	X("db/private/tel-plugin-vconf/pkt_counters", VCONF_TYPE_STRING, 0, "", VCONF_SCHEMA_FORCE) \
+	X("memory/private/tel-plugin-vconf/dump_metrics", VCONF_TYPE_INT, 0, NULL, VCONF_SCHEMA_DEFAULT) \
+	X("db/telephony/emergency", VCONF_TYPE_INT, 0, NULL, VCONF_SCHEMA_DEFAULT)
+
+struct vconf_schema_entry {
+	const char *name;
+	int type;
+	int ival;
+	const char *sval;
+	unsigned int flags;
+};
+
+#define VCONF_SCHEMA_ENTRY(name, type, ival, sval, flags) \
+	{ name, type, ival, sval, flags },
+
+#endif
@@ -0,0 +1,40 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VCONF_SHM_WRITER_H__
+#define __VCONF_SHM_WRITER_H__
+
+#include "vconf-shm.h"
+
+/* plugin side of the shared-memory mirror, see vconf-shm.h */
+gboolean vconf_shm_writer_open(unsigned int count);
+void vconf_shm_writer_close(void);
+
+void vconf_shm_writer_add(unsigned int slot, const char *name, enum vconf_shm_type type);
+void vconf_shm_writer_publish(void);
+
+void vconf_shm_writer_set_int(unsigned int slot, int value);
+void vconf_shm_writer_set_str(unsigned int slot, const char *value);
+void vconf_shm_writer_invalidate(unsigned int slot);
+
+gboolean vconf_shm_writer_get_int(unsigned int slot, int *value);
+char *vconf_shm_writer_get_str(unsigned int slot);
+
+#endif
@@ -0,0 +1,91 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VCONF_SHM_H__
+#define __VCONF_SHM_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Shared-memory mirror of the volatile (memory/) telephony keys
+ *
+ * When enabled ([general] shm=true), tel-plugin-vconf publishes the
+ * memory/ keys it knows, except device and subscriber identifiers, into
+ * a POSIX shared-memory object readable by its owner and group. Readers
+ * map it read-only and take lock-free snapshots guarded by a sequence
+ * counter: the writer makes seq odd while it updates entries and even
+ * again afterwards, so a reader that sees the same even seq before and
+ * after copying has a consistent copy.
+ *
+ * A string of VCONF_SHM_STR_MAX bytes or more is not mirrored; its entry
+ * reads as invalid and the value has to be read from vconf.
+ *
+ * Every plugin start creates a new object and clears the magic of the
+ * previous one, which stays mapped by its readers. A reader that gets
+ * vconf_shm_stale() != 0 has to close and open the region again.
+ */
+#define VCONF_SHM_NAME "/tel-plugin-vconf"
+#define VCONF_SHM_MAGIC 0x54565348 /* "TVSH" */
+#define VCONF_SHM_VERSION 1
+#define VCONF_SHM_NAME_MAX 64
+#define VCONF_SHM_STR_MAX 64
+#define VCONF_SHM_MODE 0640
+
+enum vconf_shm_type {
+	VCONF_SHM_TYPE_INT = 1,
+	VCONF_SHM_TYPE_BOOL,
+	VCONF_SHM_TYPE_STRING,
+};
+
+struct vconf_shm_entry {
+	char name[VCONF_SHM_NAME_MAX];
+	uint32_t type;
+	uint32_t valid;
+	int32_t ival;
+	char sval[VCONF_SHM_STR_MAX];
+};
+
+struct vconf_shm_header {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t count;
+	volatile uint32_t seq;
+	struct vconf_shm_entry entries[];
+};
+
+typedef struct vconf_shm VconfShm;
+
+VconfShm *vconf_shm_open(void);
+void vconf_shm_close(VconfShm *shm);
+
+/* 1 once the writer has exited or restarted */
+int vconf_shm_stale(VconfShm *shm);
+
+/* slot of a vconf key name, or -1; resolve once and reuse */
+int vconf_shm_find(VconfShm *shm, const char *name);
+
+int vconf_shm_get_int(VconfShm *shm, int slot, int *value);
+int vconf_shm_get_str(VconfShm *shm, int slot, char *buf, size_t len);
+
+/* consistent copy of up to count entries; returns the number copied */
+int vconf_shm_snapshot(VconfShm *shm, struct vconf_shm_entry *out, int count);
+
+#endif
@@ -0,0 +1,187 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VCONF_STORAGE_H__
+#define __VCONF_STORAGE_H__
+
+#include <dlfcn.h>
+
+/*
+ * Extensions of the "vconf" storage that do not fit in
+ * struct storage_operations. The Storage argument is the handle returned
+ * by tcore_server_find_storage(s, "vconf").
+ *
+ * The plugin is a module dlopen()ed by tcore without a soname, so other
+ * plugins cannot link against these functions. Resolve them at run time
+ * through the published table instead, see vconf_storage_api_get() at
+ * the end of this file.
+ */
+
+typedef void (*VconfStorageKeyCallback)(Storage *strg, enum tcore_storage_key key, void *value, void *user_data);
+
+gboolean vconf_storage_add_key_callback(Storage *strg, enum tcore_storage_key key, VconfStorageKeyCallback cb, void *user_data);
+gboolean vconf_storage_remove_key_callback(Storage *strg, enum tcore_storage_key key, VconfStorageKeyCallback cb, void *user_data);
+
+/*
+ * Registering the same cb/user_data again takes another reference; it is
+ * still dispatched once per change and removed by the last remove call.
+ * The bulk variants return the number of keys handled.
+ */
+int vconf_storage_add_key_callbacks(Storage *strg, const enum tcore_storage_key *keys, unsigned int count,
+		VconfStorageKeyCallback cb, void *user_data);
+int vconf_storage_remove_key_callbacks(Storage *strg, const enum tcore_storage_key *keys, unsigned int count,
+		VconfStorageKeyCallback cb, void *user_data);
+
+/* number of vconf key watches held, one per key shared by all subscribers */
+unsigned int vconf_storage_active_watches(void);
+
+/*
+ * Batched dispatch: changes of the registered keys within one main-loop
+ * iteration (or [general] dispatch_window ms) arrive as one array. A key
+ * appears once, with its latest value. Values are only valid during the
+ * call; take a reference to keep one.
+ */
+struct vconf_storage_change {
+	enum tcore_storage_key key;
+	GVariant *value;
+};
+
+typedef void (*VconfStorageBatchCallback)(Storage *strg, const struct vconf_storage_change *changes,
+		unsigned int count, void *user_data);
+
+int vconf_storage_add_batch_callback(Storage *strg, const enum tcore_storage_key *keys, unsigned int count,
+		VconfStorageBatchCallback cb, void *user_data);
+gboolean vconf_storage_remove_batch_callback(Storage *strg, VconfStorageBatchCallback cb, void *user_data);
+
+/* per-key dispatches saved by batching: superseded values plus changes folded into one call */
+unsigned int vconf_storage_collapsed_dispatches(void);
+
+/*
+ * One result of vconf_storage_get_multi(). ival holds int and bool keys,
+ * sval string keys (release with free()).
+ */
+struct vconf_storage_value {
+	gboolean valid;
+	int ival;
+	char *sval;
+};
+
+/*
+ * Reads count keys in one call, filling values[i] for keys[i]. Returns
+ * the number of valid results, or -1 on bad arguments.
+ */
+int vconf_storage_get_multi(Storage *strg, const enum tcore_storage_key *keys,
+		struct vconf_storage_value *values, unsigned int count);
+
+/*
+ * Full 64-bit value of a cellular packet counter
+ * (STORAGE_KEY_CELLULAR_PKT_*). FALSE for any other key.
+ */
+gboolean vconf_storage_get_int64(Storage *strg, enum tcore_storage_key key, gint64 *value);
+gboolean vconf_storage_set_int64(Storage *strg, enum tcore_storage_key key, gint64 value);
+
+/*
+ * Radio history (RSSI, CELLID, LAC, SVCTYPE, PSTYPE changes) recorded
+ * with from <= time < to, oldest first; see vconf-radio.h.
+ */
+struct vconf_radio_record;
+guint vconf_storage_get_radio_history(gint64 from, gint64 to, struct vconf_radio_record *out, guint max);
+
+/* wait until every queued write-behind write has reached vconf */
+void vconf_storage_flush(void);
+
+/*
+ * Per-hook and per-op latency and per-key write/notification counters,
+ * as text or JSON. Release the result with g_free().
+ */
+gchar *vconf_storage_dump_metrics(gboolean json);
+
+/*
+ * Event trace ([general] trace=<events per thread>) as Chrome trace
+ * JSON; see vconf-trace.h. Release the result with g_free().
+ */
+gchar *vconf_storage_dump_trace(void);
+
+/*
+ * Function table of the entry points above, exported by the loaded plugin
+ * as VCONF_STORAGE_API_SYMBOL. Fields are only ever appended: check
+ * version before using a field added after VCONF_STORAGE_API_VERSION 1.
+ */
+#define VCONF_STORAGE_PLUGIN_PATH "/usr/lib/telephony/plugins/vconf-plugin.so"
+#define VCONF_STORAGE_API_SYMBOL "vconf_storage_api"
+#define VCONF_STORAGE_API_VERSION 1
+
+struct vconf_storage_api {
+	unsigned int version;
+
+	gboolean (*add_key_callback)(Storage *strg, enum tcore_storage_key key,
+			VconfStorageKeyCallback cb, void *user_data);
+	gboolean (*remove_key_callback)(Storage *strg, enum tcore_storage_key key,
+			VconfStorageKeyCallback cb, void *user_data);
+	int (*add_key_callbacks)(Storage *strg, const enum tcore_storage_key *keys, unsigned int count,
+			VconfStorageKeyCallback cb, void *user_data);
+	int (*remove_key_callbacks)(Storage *strg, const enum tcore_storage_key *keys, unsigned int count,
+			VconfStorageKeyCallback cb, void *user_data);
+	unsigned int (*active_watches)(void);
+
+	int (*add_batch_callback)(Storage *strg, const enum tcore_storage_key *keys, unsigned int count,
+			VconfStorageBatchCallback cb, void *user_data);
+	gboolean (*remove_batch_callback)(Storage *strg, VconfStorageBatchCallback cb, void *user_data);
+	unsigned int (*collapsed_dispatches)(void);
+
+	int (*get_multi)(Storage *strg, const enum tcore_storage_key *keys,
+			struct vconf_storage_value *values, unsigned int count);
+	gboolean (*get_int64)(Storage *strg, enum tcore_storage_key key, gint64 *value);
+	gboolean (*set_int64)(Storage *strg, enum tcore_storage_key key, gint64 value);
+
+	guint (*get_radio_history)(gint64 from, gint64 to, struct vconf_radio_record *out, guint max);
+	void (*flush)(void);
+	gchar *(*dump_metrics)(gboolean json);
+	gchar *(*dump_trace)(void);
+};
+
+/*
+ * Table of the plugin loaded by tcore, or NULL if it is not loaded. Never
+ * loads a second copy (RTLD_NOLOAD). Call it from the consumer's init();
+ * the table stays valid until the vconf plugin is unloaded, e.g.
+ *
+ *	const struct vconf_storage_api *api = vconf_storage_api_get();
+ *
+ *	if (api)
+ *		api->get_multi(strg, keys, values, G_N_ELEMENTS(keys));
+ */
+static inline const struct vconf_storage_api *vconf_storage_api_get(void)
+{
+	const struct vconf_storage_api *api;
+	void *handle;
+
+	handle = dlopen(VCONF_STORAGE_PLUGIN_PATH, RTLD_NOW | RTLD_NOLOAD);
+	if (!handle)
+		return NULL;
+
+	api = dlsym(handle, VCONF_STORAGE_API_SYMBOL);
+
+	/* drops only the reference taken above; tcore keeps its own */
+	dlclose(handle);
+
+	return api;
+}
+
+#endif
@@ -0,0 +1,73 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VCONF_TRACE_H__
+#define __VCONF_TRACE_H__
+
+/*
+ * Event trace: timestamped begin/end events of hooks, vconf writes and
+ * key change callbacks. Every thread records into its own ring without
+ * taking a lock; the oldest events are overwritten once a ring is full.
+ *
+ * Each hook opens a flow. Writes made on behalf of the hook carry its
+ * flow id, even when they are deferred or performed by the write-behind
+ * thread, so the export can link every write to its notification.
+ */
+enum vconf_trace_kind {
+	VCONF_TRACE_HOOK,	/* name: hook, arg: notification command */
+	VCONF_TRACE_SET,	/* name: key or "keylist", arg: number of keys */
+	VCONF_TRACE_CALLBACK,	/* name: key */
+	VCONF_TRACE_RECONCILE,	/* name: step */
+	VCONF_TRACE_LINK,	/* flow consumed by the enclosing span */
+	VCONF_TRACE_KIND_MAX
+};
+
+struct vconf_trace_event {
+	gint64 time;		/* g_get_monotonic_time(), us */
+	const char *name;	/* static string */
+	guint32 arg;
+	guint32 size;		/* value size in bytes */
+	guint32 flow;		/* 0: none */
+	guint8 kind;		/* enum vconf_trace_kind */
+	guint8 phase;		/* 'B', 'E' or 'L' */
+};
+
+/*
+ * capacity is per thread and rounded up to a power of two, 0 disables.
+ * Call both from the main loop; free only once every other recording
+ * thread has exited.
+ */
+gboolean vconf_trace_init(guint capacity);
+void vconf_trace_free(void);
+gboolean vconf_trace_enabled(void);
+
+/* main loop only: flow ids and the flow the current work is done for */
+guint32 vconf_trace_flow_new(void);
+guint32 vconf_trace_cause(void);
+void vconf_trace_set_cause(guint32 flow);
+
+void vconf_trace_begin(enum vconf_trace_kind kind, const char *name, guint32 arg, guint32 size, guint32 flow);
+void vconf_trace_end(enum vconf_trace_kind kind, const char *name, guint32 arg, guint32 size, guint32 flow);
+void vconf_trace_link(guint32 flow);
+
+/* Chrome trace event JSON (chrome://tracing, ui.perfetto.dev) */
+gchar *vconf_trace_export(void);
+
+#endif
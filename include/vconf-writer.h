@@ -0,0 +1,73 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VCONF_WRITER_H__
+#define __VCONF_WRITER_H__
+
+/*
+ * Write-behind worker
+ *
+ * When started, vconf writes are queued and performed by a dedicated
+ * thread instead of the tcore main loop. Key names must stay valid for
+ * the lifetime of the writer (the plugin passes its static key table).
+ *
+ * - writes reach vconf in the order they were queued. A single-key
+ *   write drops a queued, not yet written value of the same key and is
+ *   appended at the tail (last writer wins, and never overtakes writes
+ *   of other keys queued before it);
+ * - a keylist is written with one vconf_set(), so its keys are seen
+ *   together, and no later write is moved in front of it;
+ * - the queue is bounded and never blocks the caller: a write that finds
+ *   it full is refused with -1 and a refused keylist stays with the
+ *   caller;
+ * - failed writes are reported to failed, on the main loop, with the
+ *   name of each key not written. Callers that cache written values have
+ *   to drop them there.
+ */
+typedef void (*VconfWriterFailed)(const char *name);
+
+gboolean vconf_writer_start(guint max_queue, VconfWriterFailed failed);
+void vconf_writer_stop(void);
+gboolean vconf_writer_running(void);
+
+int vconf_writer_set_int(const char *name, int value);
+int vconf_writer_set_bool(const char *name, int value);
+int vconf_writer_set_str(const char *name, const char *value);
+int vconf_writer_set_keylist(keylist_t *kl);
+
+/* wait until every queued write has reached vconf */
+void vconf_writer_flush(void);
+
+/* TRUE while a write of the key is queued or in progress */
+gboolean vconf_writer_pending(const char *name);
+
+/*
+ * TRUE while any write is queued or in progress. A write made directly
+ * to vconf meanwhile would overtake them.
+ */
+gboolean vconf_writer_busy(void);
+
+/*
+ * TRUE when a new write would be refused. Only the worker takes writes
+ * off the queue, so the answer holds until the caller queues again.
+ */
+gboolean vconf_writer_full(void);
+
+#endif
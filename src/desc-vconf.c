@@ -34,463 +34,2089 @@
 #include <storage.h>
 #include <co_network.h>
 
+#include "vconf-keys.h"
+#include "vconf-schema.h"
+#include "vconf-storage.h"
+#include "vconf-metrics.h"
+#include "vconf-shm-writer.h"
+#include "vconf-writer.h"
+#include "vconf-radio.h"
+#include "vconf-operator.h"
+#include "vconf-trace.h"
+
+#ifndef VCONF_PLUGIN_CONF
+#define VCONF_PLUGIN_CONF "/etc/telephony/tel-plugin-vconf.conf"
+#endif
+#define VCONF_METRICS_TRIGGER "memory/private/tel-plugin-vconf/dump_metrics"
+#define VCONF_METRICS_PATH "/tmp/tel-plugin-vconf-metrics.json"
+#define VCONF_TRACE_PATH "/tmp/tel-plugin-vconf-trace.json"
+#define VCONF_RADIO_PATH "/tmp/tel-plugin-vconf-radio.json"
+#define VCONF_WARM_STATE_PATH "/var/run/tel-plugin-vconf.state"
+#define VCONF_WARM_STATE_MAGIC "TVSTATE1"
+#define VCONF_WARM_STATE_HEADER (8 + 40)	/* magic, SHA-1 of the payload */
+#define VCONF_WARM_STATE_DELAY 2		/* s */
+#define VCONF_BOOT_ID "/proc/sys/kernel/random/boot_id"
+
 static void reset_vconf();
 
-static TcoreStorageDispatchCallback callback_dispatch;
+#define VCONF_KEY_DESC(id, strg_key, name) \
+	[VKEY_##id] = { strg_key, name, VCONF_KEY_TYPE(strg_key) },
+
+#define VCONF_PLUGIN_KEY_DESC(id, name, type) \
+	[VKEY_##id] = { 0, name, type },
+
+static const struct vconf_key_desc vconf_keys[VKEY_MAX] = {
+	VCONF_STORAGE_KEYS(VCONF_KEY_DESC)
+	VCONF_PLUGIN_KEYS(VCONF_PLUGIN_KEY_DESC)
+};
+
+#define VCONF_KEY_PRIO(id, prio) \
+	[VKEY_##id] = VKEY_PRIO_##prio,
+
+static const enum vconf_key_prio key_prio[VKEY_MAX] = {
+	VCONF_KEY_PRIORITIES(VCONF_KEY_PRIO)
+};
+
+#define VCONF_KEY_PRIVATE(id) \
+	[VKEY_##id] = TRUE,
+
+static const gboolean key_private[VKEY_MAX] = {
+	VCONF_PRIVATE_KEYS(VCONF_KEY_PRIVATE)
+};
+
+static const struct vconf_schema_entry vconf_schema[] = {
+	VCONF_SCHEMA(VCONF_SCHEMA_ENTRY)
+};
+
+/* vconf key name -> (key id + 1), filled once at on_init */
+static GHashTable *vconf_key_index;
+
+/* VCONF_SCHEMA_WARM keys, by id */
+static gboolean key_warm[VKEY_MAX];
+
+static void vconf_key_index_init(void)
+{
+	gpointer id;
+	unsigned int i;
+
+	if (vconf_key_index)
+		return;
+
+	vconf_key_index = g_hash_table_new(g_str_hash, g_str_equal);
+	for (i = 0; i < VKEY_MAX; i++)
+		g_hash_table_insert(vconf_key_index, (gpointer)vconf_keys[i].name, GINT_TO_POINTER(i + 1));
+
+	for (i = 0; i < G_N_ELEMENTS(vconf_schema); i++) {
+		id = g_hash_table_lookup(vconf_key_index, vconf_schema[i].name);
+		if (id && (vconf_schema[i].flags & VCONF_SCHEMA_WARM))
+			key_warm[GPOINTER_TO_INT(id) - 1] = TRUE;
+	}
+}
+
+static void vconf_key_index_free(void)
+{
+	if (!vconf_key_index)
+		return;
+
+	g_hash_table_destroy(vconf_key_index);
+	vconf_key_index = NULL;
+}
 
-static const gchar* convert_strgkey_to_vconf(enum tcore_storage_key key)
+#define VCONF_KEY_CASE(id, strg_key, name) \
+	case strg_key: \
+		return VKEY_##id;
+
+static enum vconf_key_id convert_strgkey_to_id(enum tcore_storage_key key)
 {
 	switch (key) {
-		case STORAGE_KEY_TELEPHONY_PLMN:
-			return VCONFKEY_TELEPHONY_PLMN;
-		case STORAGE_KEY_TELEPHONY_LAC:
-			return VCONFKEY_TELEPHONY_LAC;
-		case STORAGE_KEY_TELEPHONY_CELLID:
-			return VCONFKEY_TELEPHONY_CELLID;
-		case STORAGE_KEY_TELEPHONY_SVCTYPE:
-			return VCONFKEY_TELEPHONY_SVCTYPE;
-		case STORAGE_KEY_TELEPHONY_SVC_CS:
-			return VCONFKEY_TELEPHONY_SVC_CS;
-		case STORAGE_KEY_TELEPHONY_SVC_PS:
-			return VCONFKEY_TELEPHONY_SVC_PS;
-		case STORAGE_KEY_TELEPHONY_SVC_ROAM:
-			return VCONFKEY_TELEPHONY_SVC_ROAM;
-		case STORAGE_KEY_TELEPHONY_ZONE_TYPE:
-			return VCONFKEY_TELEPHONY_ZONE_TYPE;
-		case STORAGE_KEY_TELEPHONY_SIM_INIT:
-			return VCONFKEY_TELEPHONY_SIM_INIT;
-		case STORAGE_KEY_TELEPHONY_SIM_CHV:
-			return VCONFKEY_TELEPHONY_SIM_CHV;
-		case STORAGE_KEY_TELEPHONY_SIM_PB_INIT:
-			return VCONFKEY_TELEPHONY_SIM_PB_INIT;
-		case STORAGE_KEY_TELEPHONY_CALL_STATE:
-			return VCONFKEY_TELEPHONY_CALL_STATE;
-		case STORAGE_KEY_TELEPHONY_CALL_FORWARD_STATE:
-			return VCONFKEY_TELEPHONY_CALL_FORWARD_STATE;
-		case STORAGE_KEY_TELEPHONY_TAPI_STATE:
-			return VCONFKEY_TELEPHONY_TAPI_STATE;
-		case STORAGE_KEY_TELEPHONY_SPN_DISP_CONDITION:
-			return VCONFKEY_TELEPHONY_SPN_DISP_CONDITION;
-		case STORAGE_KEY_TELEPHONY_SAT_STATE:
-			return VCONFKEY_TELEPHONY_SAT_STATE;
-		case STORAGE_KEY_TELEPHONY_ZONE_ZUHAUSE:
-			return VCONFKEY_TELEPHONY_ZONE_ZUHAUSE;
-		case STORAGE_KEY_TELEPHONY_RSSI:
-			return VCONFKEY_TELEPHONY_RSSI;
-		case STORAGE_KEY_TELEPHONY_LOW_BATTERY:
-			return VCONFKEY_TELEPHONY_LOW_BATTERY;
-		case STORAGE_KEY_TELEPHONY_EVENT_SYSTEM_READY:
-			return "memory/telephony/event_system_ready";
-		case STORAGE_KEY_TELEPHONY_READY:
-			return VCONFKEY_TELEPHONY_READY;
-		case STORAGE_KEY_TELEPHONY_SIM_SLOT:
-			return VCONFKEY_TELEPHONY_SIM_SLOT;
-		case STORAGE_KEY_PM_STATE:
-			return VCONFKEY_PM_STATE;
-		case STORAGE_KEY_PACKET_SERVICE_STATE:
-			return VCONFKEY_DNET_STATE;
-		case STORAGE_KEY_MESSAGE_NETWORK_MODE:
-			return VCONFKEY_MESSAGE_NETWORK_MODE;
-		case STORAGE_KEY_3G_ENABLE:
-			return VCONFKEY_3G_ENABLE;
-		case STORAGE_KEY_SETAPPL_STATE_DATA_ROAMING_BOOL:
-			return VCONFKEY_SETAPPL_STATE_DATA_ROAMING_BOOL;
-		case STORAGE_KEY_SETAPPL_STATE_AUTOMATIC_TIME_UPDATE_BOOL:
-			return VCONFKEY_SETAPPL_STATE_AUTOMATIC_TIME_UPDATE_BOOL;
-		case STORAGE_KEY_SETAPPL_FLIGHT_MODE_BOOL:
-			return VCONFKEY_SETAPPL_FLIGHT_MODE_BOOL;
-		case STORAGE_KEY_TELEPHONY_NWNAME:
-			return VCONFKEY_TELEPHONY_NWNAME;
-		case STORAGE_KEY_TELEPHONY_SPN_NAME:
-			return VCONFKEY_TELEPHONY_SPN_NAME;
-		case STORAGE_KEY_TELEPHONY_SAT_SETUP_IDLE_TEXT:
-			return VCONFKEY_TELEPHONY_SAT_SETUP_IDLE_TEXT;
-		case STORAGE_KEY_TELEPHONY_IMEI:
-			return VCONFKEY_TELEPHONY_IMEI;
-		case STORAGE_KEY_TELEPHONY_SUBSCRIBER_NUMBER:
-			return VCONFKEY_TELEPHONY_SUBSCRIBER_NUMBER;
-		case STORAGE_KEY_TELEPHONY_SUBSCRIBER_NAME:
-			return VCONFKEY_TELEPHONY_SUBSCRIBER_NAME;
-		case STORAGE_KEY_TELEPHONY_SWVERSION:
-			return VCONFKEY_TELEPHONY_SWVERSION;
-		case STORAGE_KEY_TELEPHONY_HWVERSION:
-			return VCONFKEY_TELEPHONY_HWVERSION;
-		case STORAGE_KEY_TELEPHONY_CALDATE:
-			return VCONFKEY_TELEPHONY_CALDATE;
-		case STORAGE_KEY_TELEPHONY_IMEI_FACTORY_REBOOT:
-			return VCONFKEY_TELEPHONY_IMEI_FACTORY_REBOOT;
-		case STORAGE_KEY_TELEPHONY_SIM_FACTORY_MODE:
-			return VCONFKEY_TELEPHONY_SIM_FACTORY_MODE;
-		case STORAGE_KEY_TELEPHONY_PRODUCTCODE:
-			return VCONFKEY_TELEPHONY_PRODUCTCODE;
-		case STORAGE_KEY_TELEPHONY_FACTORY_KSTRINGB:
-			return VCONFKEY_TELEPHONY_FACTORY_KSTRINGB;
-		case STORAGE_KEY_TELEPHONY_IMSI:
-			return "db/private/tel-plugin-vconf/imsi";
-		case STORAGE_KEY_CELLULAR_STATE:
-			return VCONFKEY_NETWORK_CELLULAR_STATE;
-		case STORAGE_KEY_CELLULAR_PKT_TOTAL_RCV:
-			return VCONFKEY_NETWORK_CELLULAR_PKT_TOTAL_RCV;
-		case STORAGE_KEY_CELLULAR_PKT_TOTAL_SNT:
-			return VCONFKEY_NETWORK_CELLULAR_PKT_TOTAL_SNT;
-		case STORAGE_KEY_CELLULAR_PKT_LAST_RCV:
-			return VCONFKEY_NETWORK_CELLULAR_PKT_LAST_RCV;
-		case STORAGE_KEY_CELLULAR_PKT_LAST_SNT:
-			return VCONFKEY_NETWORK_CELLULAR_PKT_LAST_SNT;
+		VCONF_STORAGE_KEYS(VCONF_KEY_CASE)
 		default:
 			break;
 	}
 
-	return NULL;
+	return VKEY_MAX;
+}
+
+static enum vconf_key_id convert_vconf_to_id(const gchar* key)
+{
+	gpointer id;
+
+	if (!key || !vconf_key_index)
+		return VKEY_MAX;
+
+	id = g_hash_table_lookup(vconf_key_index, key);
+	if (!id)
+		return VKEY_MAX;
+
+	return GPOINTER_TO_INT(id) - 1;
+}
+
+/*
+ * Shadow cache of every key in the storage key table.
+ *
+ * Filled at on_init, updated by the set_* ops and kept in sync with
+ * other writers through vconf key-change notifications, so the get_*
+ * ops are served from memory.
+ */
+struct vconf_key_cache {
+	gboolean valid;
+	int ival;
+	gchar *sval;
+};
+
+static struct vconf_key_cache key_cache[VKEY_MAX];
+static guint key_cache_hits;
+static guint key_cache_misses;
+static guint key_suppressed[VKEY_MAX];
+static guint key_writes[VKEY_MAX];
+static guint key_notifications[VKEY_MAX];
+static unsigned int active_watches;	/* vconf watches, one per key */
+static guint32 key_cause[VKEY_MAX];	/* trace flow the key was last written for */
+
+/*
+ * Storage op latency, recorded only when metrics are enabled in the
+ * configuration ([general] metrics=true)
+ */
+enum vconf_metric {
+	METRIC_SET_INT,
+	METRIC_SET_BOOL,
+	METRIC_SET_STRING,
+	METRIC_GET_INT,
+	METRIC_GET_BOOL,
+	METRIC_GET_STRING,
+	METRIC_GET_MULTI,
+	METRIC_LANE_CRITICAL,
+	METRIC_LANE_LOW,
+	METRIC_NETWORK_RECONCILE,
+	METRIC_MAX
+};
+
+static const char *metric_names[METRIC_MAX] = {
+	"set_int", "set_bool", "set_string", "get_int", "get_bool", "get_string",
+	"get_multi", "lane_critical", "lane_low",
+	"network_reconcile",
+};
+
+static gboolean metrics_enabled;
+static struct vconf_histogram metric_hist[METRIC_MAX];
+
+static gint64 metrics_begin(void)
+{
+	if (!metrics_enabled)
+		return 0;
+
+	return g_get_monotonic_time();
+}
+
+static void metrics_end(struct vconf_histogram *h, gint64 start)
+{
+	if (!start)
+		return;
+
+	vconf_histogram_add(h, g_get_monotonic_time() - start);
+}
+
+/*
+ * Shared-memory mirror of the volatile (memory/) keys, see vconf-shm.h.
+ * Opt-in ([general] shm=true). Every value entering the key cache is
+ * copied to the key's slot; private keys are never mirrored.
+ */
+static gboolean shm_enabled;
+static int key_shm_slot[VKEY_MAX];
+
+static gboolean key_is_volatile(enum vconf_key_id id)
+{
+	return g_str_has_prefix(vconf_keys[id].name, "memory/") && !key_private[id];
+}
+
+static void warm_state_changed(enum vconf_key_id id);
+
+static void key_cache_store_int(enum vconf_key_id id, int value)
+{
+	if (!key_cache[id].valid || key_cache[id].ival != value)
+		warm_state_changed(id);
+
+	key_cache[id].ival = value;
+	key_cache[id].valid = TRUE;
+
+	if (key_shm_slot[id] >= 0)
+		vconf_shm_writer_set_int(key_shm_slot[id], value);
+}
+
+static void key_cache_store_str(enum vconf_key_id id, const char *value)
+{
+	if (key_cache[id].valid != (value != NULL) || g_strcmp0(key_cache[id].sval, value) != 0)
+		warm_state_changed(id);
+
+	g_free(key_cache[id].sval);
+	key_cache[id].sval = g_strdup(value);
+	key_cache[id].valid = (value != NULL);
+
+	if (key_shm_slot[id] < 0)
+		return;
+
+	if (value)
+		vconf_shm_writer_set_str(key_shm_slot[id], value);
+	else
+		vconf_shm_writer_invalidate(key_shm_slot[id]);
+}
+
+/* the stored value is unknown; the next lookup reads vconf again */
+static void key_cache_invalidate(enum vconf_key_id id)
+{
+	key_cache[id].valid = FALSE;
+	g_free(key_cache[id].sval);
+	key_cache[id].sval = NULL;
+
+	if (key_shm_slot[id] >= 0)
+		vconf_shm_writer_invalidate(key_shm_slot[id]);
+}
+
+static void key_shm_init(void)
+{
+	unsigned int count = 0;
+	int i;
+
+	for (i = 0; i < VKEY_MAX; i++) {
+		key_shm_slot[i] = -1;
+		if (key_is_volatile(i))
+			count++;
+	}
+
+	if (!shm_enabled || !vconf_shm_writer_open(count))
+		return;
+
+	count = 0;
+	for (i = 0; i < VKEY_MAX; i++) {
+		if (!key_is_volatile(i))
+			continue;
+
+		key_shm_slot[i] = count++;
+		vconf_shm_writer_add(key_shm_slot[i], vconf_keys[i].name,
+				vconf_keys[i].type == VCONF_TYPE_STRING ? VCONF_SHM_TYPE_STRING :
+				vconf_keys[i].type == VCONF_TYPE_BOOL ? VCONF_SHM_TYPE_BOOL : VCONF_SHM_TYPE_INT);
+	}
+}
+
+static void key_shm_free(void)
+{
+	int i;
+
+	for (i = 0; i < VKEY_MAX; i++)
+		key_shm_slot[i] = -1;
+
+	vconf_shm_writer_close();
+}
+
+static gboolean key_cache_load(enum vconf_key_id id)
+{
+	const struct vconf_key_desc *desc = &vconf_keys[id];
+	int value = 0;
+	char *str;
+
+	switch (desc->type) {
+		case VCONF_TYPE_INT:
+			if (vconf_get_int(desc->name, &value) != 0)
+				return FALSE;
+			key_cache_store_int(id, value);
+			break;
+
+		case VCONF_TYPE_BOOL:
+			if (vconf_get_bool(desc->name, &value) != 0)
+				return FALSE;
+			key_cache_store_int(id, value);
+			break;
+
+		case VCONF_TYPE_STRING:
+			str = vconf_get_str(desc->name);
+			if (!str)
+				return FALSE;
+			key_cache_store_str(id, str);
+			free(str);
+			break;
+
+		default:
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void pkt_counter_notified(enum vconf_key_id id, int value);
+static void key_dispatch(keynode_t *node, enum vconf_key_id id);
+
+/*
+ * The only vconf watch of a key: it keeps the cache current and then
+ * dispatches the change to the key's subscribers, if any.
+ */
+static void __vconfkey_cache_callback(keynode_t* node, void* data)
+{
+	enum vconf_key_id id;
+
+	id = convert_vconf_to_id(vconf_keynode_get_name(node));
+	if (id == VKEY_MAX)
+		return;
+
+	/* vconf_batch_commit() replays its nodes here with no data */
+	if (data) {
+		key_notifications[id]++;
+
+		/* an older value echoed back while a newer one is still queued */
+		if (vconf_writer_pending(vconf_keys[id].name)) {
+			key_dispatch(node, id);
+			return;
+		}
+
+		if (vconf_keynode_get_type(node) == VCONF_TYPE_INT)
+			pkt_counter_notified(id, vconf_keynode_get_int(node));
+	}
+
+	switch (vconf_keynode_get_type(node)) {
+		case VCONF_TYPE_INT:
+			key_cache_store_int(id, vconf_keynode_get_int(node));
+			break;
+
+		case VCONF_TYPE_BOOL:
+			key_cache_store_int(id, vconf_keynode_get_bool(node));
+			break;
+
+		case VCONF_TYPE_STRING:
+			key_cache_store_str(id, vconf_keynode_get_str(node));
+			break;
+
+		default:
+			key_cache[id].valid = FALSE;
+			if (key_shm_slot[id] >= 0)
+				vconf_shm_writer_invalidate(key_shm_slot[id]);
+			break;
+	}
+
+	if (data)
+		key_dispatch(node, id);
+}
+
+static void key_cache_init(void)
+{
+	int i;
+
+	key_shm_init();
+
+	for (i = 0; i < VKEY_MAX; i++) {
+		key_cache_load(i);
+		if (vconf_notify_key_changed(vconf_keys[i].name, __vconfkey_cache_callback, key_cache) == 0)
+			active_watches++;
+	}
+
+	vconf_shm_writer_publish();
+}
+
+static void key_cache_free(void)
+{
+	int i;
+
+	dbg("key cache: hits(%u) misses(%u)", key_cache_hits, key_cache_misses);
+
+	for (i = 0; i < VKEY_MAX; i++) {
+		if (key_suppressed[i])
+			dbg("[%s] suppressed writes(%u)", vconf_keys[i].name, key_suppressed[i]);
+
+		vconf_ignore_key_changed(vconf_keys[i].name, __vconfkey_cache_callback);
+		g_free(key_cache[i].sval);
+	}
+
+	memset(key_cache, 0, sizeof(key_cache));
+	active_watches = 0;
+
+	key_shm_free();
+}
+
+static gboolean key_cache_lookup(enum vconf_key_id id)
+{
+	if (key_cache[id].valid) {
+		key_cache_hits++;
+		return TRUE;
+	}
+
+	key_cache_misses++;
+	return key_cache_load(id);
+}
+
+static void* create_handle(Storage *strg, const char *path)
+{
+	void *tmp = NULL;
+	if(!strg)
+		return NULL;
+
+	tmp = malloc(sizeof(char));
+	return tmp;
+}
+
+static gboolean remove_handle(Storage *strg, void *handle)
+{
+	if(!strg || !handle)
+		return FALSE;
+
+	free(handle);
+	return TRUE;
+}
+
+/*
+ * Backend writes go to the write-behind worker when it is running
+ * ([general] write_behind=true), otherwise straight to vconf. Critical
+ * keys are written in place when nothing is queued; otherwise they are
+ * queued too, so observers see every write in the order it was made.
+ * A write the worker refused or failed leaves the key uncached, so the
+ * next write of the same value is not suppressed.
+ */
+static gboolean write_behind;
+static guint write_queue_max = 256;
+
+static gboolean backend_async(enum vconf_key_id id)
+{
+	if (!vconf_writer_running())
+		return FALSE;
+
+	return key_prio[id] != VKEY_PRIO_CRITICAL || vconf_writer_busy();
+}
+
+static void backend_failed(const char *name)
+{
+	enum vconf_key_id id = convert_vconf_to_id(name);
+
+	if (id != VKEY_MAX)
+		key_cache_invalidate(id);
+}
+
+static gint64 backend_begin(enum vconf_key_id id)
+{
+	return key_prio[id] == VKEY_PRIO_CRITICAL ? metrics_begin() : 0;
+}
+
+/* a backend write runs under the trace flow its key was last written for */
+static guint32 backend_trace_begin(enum vconf_key_id id, guint32 size)
+{
+	guint32 cause = vconf_trace_cause();
+
+	vconf_trace_set_cause(key_cause[id]);
+	vconf_trace_begin(VCONF_TRACE_SET, vconf_keys[id].name, 1, size, key_cause[id]);
+	return cause;
+}
+
+static void backend_trace_end(enum vconf_key_id id, guint32 size, guint32 cause)
+{
+	vconf_trace_end(VCONF_TRACE_SET, vconf_keys[id].name, 1, size, key_cause[id]);
+	vconf_trace_set_cause(cause);
+}
+
+static int backend_set_int(enum vconf_key_id id, int value)
+{
+	gint64 start = backend_begin(id);
+	guint32 cause = backend_trace_begin(id, sizeof(int));
+	int ret;
+
+	if (backend_async(id))
+		ret = vconf_writer_set_int(vconf_keys[id].name, value);
+	else
+		ret = vconf_set_int(vconf_keys[id].name, value);
+
+	backend_trace_end(id, sizeof(int), cause);
+	metrics_end(&metric_hist[METRIC_LANE_CRITICAL], start);
+	return ret;
+}
+
+static int backend_set_bool(enum vconf_key_id id, int value)
+{
+	gint64 start = backend_begin(id);
+	guint32 cause = backend_trace_begin(id, sizeof(int));
+	int ret;
+
+	if (backend_async(id))
+		ret = vconf_writer_set_bool(vconf_keys[id].name, value);
+	else
+		ret = vconf_set_bool(vconf_keys[id].name, value);
+
+	backend_trace_end(id, sizeof(int), cause);
+	metrics_end(&metric_hist[METRIC_LANE_CRITICAL], start);
+	return ret;
+}
+
+static int backend_set_str(enum vconf_key_id id, const char *value)
+{
+	gint64 start = backend_begin(id);
+	guint32 size = value ? strlen(value) + 1 : 0;
+	guint32 cause = backend_trace_begin(id, size);
+	int ret;
+
+	if (backend_async(id))
+		ret = vconf_writer_set_str(vconf_keys[id].name, value);
+	else
+		ret = vconf_set_str(vconf_keys[id].name, value);
+
+	backend_trace_end(id, size, cause);
+	metrics_end(&metric_hist[METRIC_LANE_CRITICAL], start);
+	return ret;
+}
+
+/*
+ * Low-priority lane: the latest value of each LOW key is held and all of
+ * them are published in one batch once the main loop is idle.
+ */
+struct vconf_low_lane {
+	gboolean pending;
+	int value;
+	gint64 queued;	/* metrics only */
+};
+
+static struct vconf_low_lane low_lane[VKEY_MAX];
+static guint low_lane_idle;
+
+static gboolean low_lane_flush(gpointer user_data);
+
+static void low_lane_defer(enum vconf_key_id id, int value)
+{
+	struct vconf_low_lane *ll = &low_lane[id];
+
+	if (!ll->pending)
+		ll->queued = metrics_begin();
+
+	ll->pending = TRUE;
+	ll->value = value;
+
+	if (!low_lane_idle)
+		low_lane_idle = g_idle_add_full(G_PRIORITY_LOW, low_lane_flush, NULL, NULL);
+}
+
+static void low_lane_cancel_all(void)
+{
+	if (low_lane_idle)
+		g_source_remove(low_lane_idle);
+
+	low_lane_idle = 0;
+	memset(low_lane, 0, sizeof(low_lane));
+}
+
+/*
+ * Single write path for every vconf write made by the plugin.
+ *
+ * A write that would not change the last published value (as held by
+ * the key cache) is dropped, so listeners are only woken by real changes.
+ */
+static gboolean vconf_publish_int(enum vconf_key_id id, int value)
+{
+	if (key_cache[id].valid && key_cache[id].ival == value) {
+		low_lane[id].pending = FALSE;
+		low_lane[id].queued = 0;
+		key_suppressed[id]++;
+		return TRUE;
+	}
+
+	if (key_prio[id] == VKEY_PRIO_LOW) {
+		if (low_lane[id].pending)
+			key_suppressed[id]++;
+		low_lane_defer(id, value);
+		return TRUE;
+	}
+
+	if (backend_set_int(id, value) != 0)
+		return FALSE;
+
+	key_writes[id]++;
+	key_cache_store_int(id, value);
+	return TRUE;
+}
+
+/*
+ * Per-key rate limiting for int keys (RSSI, CELLID, LAC, ...)
+ *
+ * A value is published right away only when min_interval has elapsed
+ * since the last write and it differs from the published value by at
+ * least hysteresis. Anything else is held back and the latest held value
+ * is published by a trailing timer, so intermediate values are dropped
+ * but the final one always reaches vconf.
+ *
+ * The timer fires flush_delay ms after the value was held, min_interval
+ * by default. A hysteresis-only policy defaults to
+ * VCONF_HYSTERESIS_FLUSH_DELAY, since a held value flushed on the next
+ * main-loop iteration would defeat the hysteresis.
+ */
+#define VCONF_HYSTERESIS_FLUSH_DELAY 2000	/* ms */
+
+struct vconf_key_policy {
+	guint min_interval;	/* ms */
+	guint flush_delay;	/* ms */
+	int hysteresis;
+
+	gint64 last_write;	/* monotonic, us */
+	gboolean pending;
+	int pending_value;
+	guint timer;
+};
+
+static struct vconf_key_policy key_policy[VKEY_MAX];
+
+static gboolean key_policy_flush(gpointer user_data)
+{
+	enum vconf_key_id id = GPOINTER_TO_INT(user_data);
+	struct vconf_key_policy *kp = &key_policy[id];
+
+	kp->timer = 0;
+
+	if (kp->pending) {
+		kp->pending = FALSE;
+		kp->last_write = g_get_monotonic_time();
+		vconf_publish_int(id, kp->pending_value);
+	}
+
+	return FALSE;
+}
+
+static void key_policy_cancel(enum vconf_key_id id)
+{
+	struct vconf_key_policy *kp = &key_policy[id];
+
+	if (kp->timer)
+		g_source_remove(kp->timer);
+
+	kp->timer = 0;
+	kp->pending = FALSE;
+}
+
+static void key_policy_cancel_all(void)
+{
+	int i;
+
+	for (i = 0; i < VKEY_MAX; i++)
+		key_policy_cancel(i);
+}
+
+static gboolean key_policy_write(enum vconf_key_id id, int value)
+{
+	struct vconf_key_policy *kp = &key_policy[id];
+	gint64 now = g_get_monotonic_time();
+	gint64 elapsed = (now - kp->last_write) / 1000;
+	gint64 delay;
+
+	if (key_cache[id].valid && key_cache[id].ival == value) {
+		/* back at the published value: nothing left to flush */
+		key_policy_cancel(id);
+		key_suppressed[id]++;
+		return TRUE;
+	}
+
+	if (elapsed >= kp->min_interval && !kp->pending
+			&& (!key_cache[id].valid || ABS(value - key_cache[id].ival) >= kp->hysteresis)) {
+		kp->last_write = now;
+		return vconf_publish_int(id, value);
+	}
+
+	kp->pending = TRUE;
+	kp->pending_value = value;
+	key_suppressed[id]++;
+
+	if (!kp->timer) {
+		delay = MAX((gint64)kp->min_interval - elapsed, (gint64)kp->flush_delay);
+		kp->timer = g_timeout_add(MAX(delay, 0), key_policy_flush, GINT_TO_POINTER(id));
+	}
+
+	return TRUE;
+}
+
+static void key_policy_load(GKeyFile *kf)
+{
+	struct vconf_key_policy *kp;
+	int i;
+
+	for (i = 0; i < VKEY_MAX; i++) {
+		if (vconf_keys[i].type != VCONF_TYPE_INT)
+			continue;
+
+		if (!g_key_file_has_group(kf, vconf_keys[i].name))
+			continue;
+
+		kp = &key_policy[i];
+		kp->min_interval = MAX(g_key_file_get_integer(kf, vconf_keys[i].name, "min_interval", NULL), 0);
+		kp->hysteresis = MAX(g_key_file_get_integer(kf, vconf_keys[i].name, "hysteresis", NULL), 0);
+		kp->flush_delay = MAX(g_key_file_get_integer(kf, vconf_keys[i].name, "flush_delay", NULL), 0);
+		if (!kp->flush_delay)
+			kp->flush_delay = kp->min_interval;
+		if (!kp->flush_delay && kp->hysteresis)
+			kp->flush_delay = VCONF_HYSTERESIS_FLUSH_DELAY;
+
+		dbg("[%s] min_interval(%u) hysteresis(%d) flush_delay(%u)", vconf_keys[i].name,
+				kp->min_interval, kp->hysteresis, kp->flush_delay);
+	}
+}
+
+/*
+ * A value held back by the key's rate limit or waiting in the low lane
+ * is already the key's value for readers in this process; only its
+ * publication to vconf is pending.
+ */
+static gboolean key_pending_int(enum vconf_key_id id, int *value)
+{
+	if (key_policy[id].pending) {
+		*value = key_policy[id].pending_value;
+		return TRUE;
+	}
+
+	if (low_lane[id].pending) {
+		*value = low_lane[id].value;
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+/*
+ * Per-notification staging
+ *
+ * While a hook runs, vconf_write_*() only record the value and a later
+ * write to a key replaces the earlier one. on_hook() commits the stage
+ * when the handler returns, so each key is written at most once per
+ * notification and listeners never see transient values such as
+ * "Searching..." right before the real network name.
+ */
+struct vconf_stage {
+	gboolean active;
+	unsigned int count;
+	enum vconf_key_id order[VKEY_MAX];
+	gboolean staged[VKEY_MAX];
+	int ival[VKEY_MAX];
+	char *sval[VKEY_MAX];
+};
+
+static struct vconf_stage stage;
+
+static void stage_key(enum vconf_key_id id)
+{
+	if (stage.staged[id]) {
+		key_suppressed[id]++;
+		return;
+	}
+
+	stage.staged[id] = TRUE;
+	stage.order[stage.count++] = id;
+}
+
+static void stage_clear(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < stage.count; i++) {
+		stage.staged[stage.order[i]] = FALSE;
+		g_free(stage.sval[stage.order[i]]);
+		stage.sval[stage.order[i]] = NULL;
+	}
+
+	stage.count = 0;
+}
+
+/*
+ * Warm restart ([general] warm_restart=true): the derived display state
+ * (VCONF_SCHEMA_WARM keys: network name, PLMN, cell, service, SIM slot,
+ * SPN, RSSI) is kept in a snapshot and restored at on_init instead of
+ * the blind reset, see warm_state_save() and warm_state_load(). Readiness
+ * and call state always start from their defaults: they describe the
+ * modem and calls, which do not survive the process.
+ */
+static gboolean warm_restart;
+static guint warm_restart_max_age = 60;	/* s */
+static guint warm_restart_grace = 30;	/* s */
+static guint warm_state_timer;
+static guint warm_reconcile_timer;
+static gboolean warm_unconfirmed[VKEY_MAX];
+
+static gboolean __warm_state_timeout(gpointer user_data);
+
+static void warm_state_schedule(void)
+{
+	if (warm_restart && !warm_state_timer)
+		warm_state_timer = g_timeout_add_seconds(VCONF_WARM_STATE_DELAY, __warm_state_timeout, NULL);
+}
+
+/*
+ * The snapshot is rewritten only when its content changes: a WARM key
+ * takes a new value, or a restored key is confirmed. Any write of a
+ * restored key, even an unchanged value, confirms it.
+ */
+static void warm_state_changed(enum vconf_key_id id)
+{
+	if (key_warm[id])
+		warm_state_schedule();
+}
+
+static void warm_state_touch(enum vconf_key_id id)
+{
+	if (!warm_unconfirmed[id])
+		return;
+
+	warm_unconfirmed[id] = FALSE;
+	warm_state_schedule();
+}
+
+static gboolean vconf_write_int(enum vconf_key_id id, int value)
+{
+	warm_state_touch(id);
+	key_cause[id] = vconf_trace_cause();
+
+	if (stage.active) {
+		stage_key(id);
+		stage.ival[id] = value;
+		return TRUE;
+	}
+
+	if (key_prio[id] == VKEY_PRIO_CRITICAL)
+		return vconf_publish_int(id, value);
+
+	if (key_policy[id].min_interval || key_policy[id].hysteresis)
+		return key_policy_write(id, value);
+
+	return vconf_publish_int(id, value);
 }
 
-static enum tcore_storage_key convert_vconf_to_strgkey(const gchar* key)
+static gboolean vconf_write_bool(enum vconf_key_id id, gboolean value)
 {
-	if (g_str_equal(key, VCONFKEY_TELEPHONY_PLMN) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_PLMN;
-	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_LAC) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_LAC;
-	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_CELLID) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_CELLID;
-	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_SVCTYPE) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_SVCTYPE;
-	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_SVC_CS) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_SVC_CS;
-	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_SVC_PS) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_SVC_PS;
-	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_SVC_ROAM) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_SVC_ROAM;
-	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_ZONE_TYPE) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_ZONE_TYPE;
-	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_SIM_INIT) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_SIM_INIT;
-	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_SIM_CHV) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_SIM_CHV;
-	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_SIM_PB_INIT) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_SIM_PB_INIT;
-	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_CALL_STATE) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_CALL_STATE;
-	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_CALL_FORWARD_STATE) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_CALL_FORWARD_STATE;
-	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_TAPI_STATE) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_TAPI_STATE;
+	value = value ? TRUE : FALSE;
+	warm_state_touch(id);
+	key_cause[id] = vconf_trace_cause();
+
+	if (stage.active) {
+		stage_key(id);
+		stage.ival[id] = value;
+		return TRUE;
 	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_SPN_DISP_CONDITION) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_SPN_DISP_CONDITION;
-	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_SAT_STATE) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_SAT_STATE;
-	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_ZONE_ZUHAUSE) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_ZONE_ZUHAUSE;
-	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_RSSI) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_RSSI;
-	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_LOW_BATTERY) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_LOW_BATTERY;
-	}
-	else if (g_str_equal(key, "memory/telephony/event_system_ready") == TRUE) {
-		return STORAGE_KEY_TELEPHONY_EVENT_SYSTEM_READY;
-	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_READY) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_READY;
-	}
-	else if (g_str_equal(key, VCONFKEY_3G_ENABLE) == TRUE) {
-		return STORAGE_KEY_3G_ENABLE;
-	}
-	else if (g_str_equal(key, VCONFKEY_SETAPPL_STATE_DATA_ROAMING_BOOL) == TRUE) {
-		return STORAGE_KEY_SETAPPL_STATE_DATA_ROAMING_BOOL;
-	}
-	else if (g_str_equal(key, VCONFKEY_PM_STATE) == TRUE) {
-		return STORAGE_KEY_PM_STATE;
-	}
-	else if (g_str_equal(key, VCONFKEY_MESSAGE_NETWORK_MODE) == TRUE) {
-		return STORAGE_KEY_MESSAGE_NETWORK_MODE;
+
+	if (key_cache[id].valid && key_cache[id].ival == value) {
+		key_suppressed[id]++;
+		return TRUE;
 	}
-	else if (g_str_equal(key, VCONFKEY_SETAPPL_STATE_AUTOMATIC_TIME_UPDATE_BOOL) == TRUE) {
-		return STORAGE_KEY_SETAPPL_STATE_AUTOMATIC_TIME_UPDATE_BOOL;
+
+	if (backend_set_bool(id, value) != 0)
+		return FALSE;
+
+	key_writes[id]++;
+	key_cache_store_int(id, value);
+	return TRUE;
+}
+
+static gboolean vconf_write_str(enum vconf_key_id id, const char *value)
+{
+	if (!value)
+		return FALSE;
+
+	warm_state_touch(id);
+	key_cause[id] = vconf_trace_cause();
+
+	if (stage.active) {
+		stage_key(id);
+		g_free(stage.sval[id]);
+		stage.sval[id] = g_strdup(value);
+		return TRUE;
 	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_SIM_SLOT) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_SIM_SLOT;
+
+	if (key_cache[id].valid && g_strcmp0(key_cache[id].sval, value) == 0) {
+		key_suppressed[id]++;
+		return TRUE;
 	}
-	else if (g_str_equal(key, VCONFKEY_SETAPPL_FLIGHT_MODE_BOOL) == TRUE) {
-		return STORAGE_KEY_SETAPPL_FLIGHT_MODE_BOOL;
+
+	if (backend_set_str(id, value) != 0)
+		return FALSE;
+
+	key_writes[id]++;
+	key_cache_store_str(id, value);
+	return TRUE;
+}
+
+/*
+ * Batched writes
+ *
+ * Values are collected in a vconf keylist and published with a single
+ * vconf_set(). Keys already holding the value are left out.
+ */
+struct vconf_batch {
+	keylist_t *kl;
+	int count;
+	guint32 size;	/* value bytes, for the trace */
+	guint32 flow;	/* latest trace flow of the keys */
+};
+
+static void vconf_batch_begin(struct vconf_batch *b)
+{
+	b->kl = vconf_keylist_new();
+	b->count = 0;
+	b->size = 0;
+	b->flow = 0;
+}
+
+static void vconf_batch_added(struct vconf_batch *b, enum vconf_key_id id, guint32 size)
+{
+	b->count++;
+	b->size += size;
+	b->flow = MAX(b->flow, key_cause[id]);
+}
+
+static void vconf_batch_int(struct vconf_batch *b, enum vconf_key_id id, int value)
+{
+	if (key_cache[id].valid && key_cache[id].ival == value) {
+		key_suppressed[id]++;
+		return;
 	}
-	else if (g_str_equal(key, VCONFKEY_DNET_STATE) == TRUE) {
-		return STORAGE_KEY_PACKET_SERVICE_STATE;
+
+	if (vconf_keylist_add_int(b->kl, vconf_keys[id].name, value) > 0)
+		vconf_batch_added(b, id, sizeof(int));
+}
+
+static void vconf_batch_bool(struct vconf_batch *b, enum vconf_key_id id, gboolean value)
+{
+	value = value ? TRUE : FALSE;
+
+	if (key_cache[id].valid && key_cache[id].ival == value) {
+		key_suppressed[id]++;
+		return;
 	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_NWNAME) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_NWNAME;
+
+	if (vconf_keylist_add_bool(b->kl, vconf_keys[id].name, value) > 0)
+		vconf_batch_added(b, id, sizeof(int));
+}
+
+static void vconf_batch_str(struct vconf_batch *b, enum vconf_key_id id, const char *value)
+{
+	if (!value)
+		return;
+
+	if (key_cache[id].valid && g_strcmp0(key_cache[id].sval, value) == 0) {
+		key_suppressed[id]++;
+		return;
 	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_SPN_NAME) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_SPN_NAME;
+
+	if (vconf_keylist_add_str(b->kl, vconf_keys[id].name, value) > 0)
+		vconf_batch_added(b, id, strlen(value) + 1);
+}
+
+static void vconf_batch_apply(keylist_t *kl)
+{
+	keynode_t *node;
+	enum vconf_key_id id;
+
+	vconf_keylist_rewind(kl);
+	while ((node = vconf_keylist_nextnode(kl)) != NULL) {
+		__vconfkey_cache_callback(node, NULL);
+		id = convert_vconf_to_id(vconf_keynode_get_name(node));
+		if (id != VKEY_MAX)
+			key_writes[id]++;
 	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_SAT_SETUP_IDLE_TEXT) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_SAT_SETUP_IDLE_TEXT;
+}
+
+/* returns the number of keys written, or -1 on failure */
+static int vconf_batch_commit(struct vconf_batch *b)
+{
+	int count = b->count;
+	guint32 cause = vconf_trace_cause();
+
+	vconf_trace_set_cause(b->flow);
+	if (count > 0)
+		vconf_trace_begin(VCONF_TRACE_SET, "keylist", count, b->size, b->flow);
+
+	if (count > 0 && vconf_writer_full()) {
+		err("write-behind queue full, %d keys dropped", count);
+		count = -1;
 	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_IMEI) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_IMEI;
+	else if (count > 0 && vconf_writer_running()) {
+		/* the worker owns and frees the keylist from here on */
+		vconf_batch_apply(b->kl);
+		if (vconf_writer_set_keylist(b->kl) == 0)
+			b->kl = NULL;
 	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_SUBSCRIBER_NUMBER) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_SUBSCRIBER_NUMBER;
+	else if (count > 0 && vconf_set(b->kl) != 0) {
+		err("vconf_set() failed for %d keys", count);
+		count = -1;
 	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_SUBSCRIBER_NAME) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_SUBSCRIBER_NAME;
+	else if (count > 0) {
+		vconf_batch_apply(b->kl);
 	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_SWVERSION) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_SWVERSION;
+
+	if (b->count > 0)
+		vconf_trace_end(VCONF_TRACE_SET, "keylist", b->count, b->size, b->flow);
+	vconf_trace_set_cause(cause);
+
+	if (b->kl)
+		vconf_keylist_free(b->kl);
+	b->kl = NULL;
+	b->count = 0;
+
+	return count;
+}
+
+/*
+ * Critical, low-priority and rate-limited keys take their own write path;
+ * everything else staged by the hook goes out in one batch.
+ */
+static void stage_commit(void)
+{
+	struct vconf_batch b;
+	enum vconf_key_id id;
+	gboolean plain;
+	unsigned int i;
+
+	stage.active = FALSE;
+	if (!stage.count)
+		return;
+
+	vconf_batch_begin(&b);
+	for (i = 0; i < stage.count; i++) {
+		id = stage.order[i];
+		plain = key_prio[id] == VKEY_PRIO_NORMAL
+			&& !key_policy[id].min_interval && !key_policy[id].hysteresis;
+
+		switch (vconf_keys[id].type) {
+			case VCONF_TYPE_INT:
+				if (plain)
+					vconf_batch_int(&b, id, stage.ival[id]);
+				else
+					vconf_write_int(id, stage.ival[id]);
+				break;
+
+			case VCONF_TYPE_BOOL:
+				if (plain)
+					vconf_batch_bool(&b, id, stage.ival[id]);
+				else
+					vconf_write_bool(id, stage.ival[id]);
+				break;
+
+			case VCONF_TYPE_STRING:
+				if (plain)
+					vconf_batch_str(&b, id, stage.sval[id]);
+				else
+					vconf_write_str(id, stage.sval[id]);
+				break;
+
+			default:
+				break;
+		}
 	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_HWVERSION) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_HWVERSION;
+	vconf_batch_commit(&b);
+
+	stage_clear();
+}
+
+static gboolean low_lane_flush(gpointer user_data)
+{
+	struct vconf_batch b;
+	int i;
+
+	low_lane_idle = 0;
+
+	vconf_batch_begin(&b);
+	for (i = 0; i < VKEY_MAX; i++) {
+		if (!low_lane[i].pending)
+			continue;
+
+		low_lane[i].pending = FALSE;
+		vconf_batch_int(&b, i, low_lane[i].value);
 	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_CALDATE) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_CALDATE;
+	vconf_batch_commit(&b);
+
+	for (i = 0; i < VKEY_MAX; i++) {
+		metrics_end(&metric_hist[METRIC_LANE_LOW], low_lane[i].queued);
+		low_lane[i].queued = 0;
 	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_IMEI_FACTORY_REBOOT) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_IMEI_FACTORY_REBOOT;
+
+	return FALSE;
+}
+
+/*
+ * Cellular packet counters (db/dnet/statistics/cellular)
+ *
+ * The packet service pushes these through set_int far more often than
+ * they need to reach flash. They are accumulated here as 64-bit values,
+ * reads are served from memory, and the db/ keys are written at most
+ * every pkt_flush_interval seconds, on PM state changes and at unload.
+ *
+ * The TOTAL counters are taken as 32-bit counters: an increase adds the
+ * difference to the accumulator, and a drop from the top of the 32-bit
+ * range to near 0 counts as a wrap, so the total keeps counting up. Any
+ * other value, including 0, restarts the counter there. LAST_* are per
+ * session values and stored as pushed. The int keys keep their old
+ * wrapping behaviour; the full values are persisted in
+ * VCONFKEY_TEL_PLUGIN_PKT_COUNTERS and read with vconf_storage_get_int64().
+ */
+#define PKT_WRAP_MARGIN 0x40000000U
+#define PKT_ECHO_MAX 4
+
+struct vconf_pkt_counter {
+	enum vconf_key_id id;
+	gboolean total;		/* 32-bit wraps are accumulated */
+	guint64 value;
+	int flushed[PKT_ECHO_MAX];	/* last values written to the int key */
+	guint flushed_count;
+	gboolean dirty;
+};
+
+static struct vconf_pkt_counter pkt_counters[] = {
+	{ VKEY_CELLULAR_PKT_TOTAL_RCV, TRUE },
+	{ VKEY_CELLULAR_PKT_TOTAL_SNT, TRUE },
+	{ VKEY_CELLULAR_PKT_LAST_RCV, FALSE },
+	{ VKEY_CELLULAR_PKT_LAST_SNT, FALSE },
+};
+
+static guint pkt_flush_interval = 60;	/* seconds */
+static guint radio_history = 1024;	/* records, 0 disables */
+static guint trace_events;		/* per thread, 0 disables */
+static gchar *operator_index;		/* NULL: VCONF_OPERATOR_INDEX_PATH */
+static guint pkt_flush_timer;
+
+static struct vconf_pkt_counter *pkt_counter_find(enum vconf_key_id id)
+{
+	unsigned int i;
+
+	for (i = 0; i < G_N_ELEMENTS(pkt_counters); i++) {
+		if (pkt_counters[i].id == id)
+			return &pkt_counters[i];
 	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_SIM_FACTORY_MODE) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_SIM_FACTORY_MODE;
+
+	return NULL;
+}
+
+/*
+ * Notifications of earlier flushes can still arrive after a later one
+ * (PM state change right after the timer), so the values written are
+ * remembered until their echo arrives and told apart from outside
+ * changes, such as a reset to 0.
+ */
+static void pkt_counter_flushed(struct vconf_pkt_counter *pc, int value)
+{
+	if (pc->flushed_count == PKT_ECHO_MAX) {
+		memmove(pc->flushed, pc->flushed + 1, sizeof(pc->flushed[0]) * (PKT_ECHO_MAX - 1));
+		pc->flushed_count--;
 	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_PRODUCTCODE) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_PRODUCTCODE;
+
+	pc->flushed[pc->flushed_count++] = value;
+}
+
+static gboolean pkt_counter_is_echo(struct vconf_pkt_counter *pc, int value)
+{
+	guint i;
+
+	for (i = 0; i < pc->flushed_count; i++) {
+		if (pc->flushed[i] != value)
+			continue;
+
+		pc->flushed_count--;
+		memmove(pc->flushed + i, pc->flushed + i + 1, sizeof(pc->flushed[0]) * (pc->flushed_count - i));
+		return TRUE;
 	}
-	else if (g_str_equal(key, VCONFKEY_TELEPHONY_FACTORY_KSTRINGB) == TRUE) {
-		return STORAGE_KEY_TELEPHONY_FACTORY_KSTRINGB;
+
+	return FALSE;
+}
+
+static void pkt_counters_flush(void)
+{
+	struct vconf_batch b;
+	enum vconf_key_id id;
+	gboolean dirty = FALSE;
+	int value;
+	gchar *str;
+	unsigned int i;
+
+	if (pkt_flush_timer)
+		g_source_remove(pkt_flush_timer);
+	pkt_flush_timer = 0;
+
+	vconf_batch_begin(&b);
+	for (i = 0; i < G_N_ELEMENTS(pkt_counters); i++) {
+		if (!pkt_counters[i].dirty)
+			continue;
+
+		pkt_counters[i].dirty = FALSE;
+		value = (int)(guint32)pkt_counters[i].value;
+		id = pkt_counters[i].id;
+
+		/* an unchanged key is left out of the batch and sends no echo */
+		if (!key_cache[id].valid || key_cache[id].ival != value)
+			pkt_counter_flushed(&pkt_counters[i], value);
+		vconf_batch_int(&b, id, value);
+		dirty = TRUE;
 	}
-	else if (g_str_equal(key, "db/private/tel-plugin-vconf/imsi") == TRUE) {
-		return STORAGE_KEY_TELEPHONY_IMSI;
+
+	if (dirty) {
+		str = g_strdup_printf("%" G_GUINT64_FORMAT " %" G_GUINT64_FORMAT
+				" %" G_GUINT64_FORMAT " %" G_GUINT64_FORMAT,
+				pkt_counters[0].value, pkt_counters[1].value,
+				pkt_counters[2].value, pkt_counters[3].value);
+		vconf_batch_str(&b, VKEY_PKT_COUNTERS, str);
+		g_free(str);
 	}
-	else if (g_str_equal(key, VCONFKEY_NETWORK_CELLULAR_STATE) == TRUE) {
-		return STORAGE_KEY_CELLULAR_STATE;
+
+	vconf_batch_commit(&b);
+}
+
+static gboolean __pkt_flush_timeout(gpointer user_data)
+{
+	pkt_flush_timer = 0;
+	pkt_counters_flush();
+
+	return FALSE;
+}
+
+/*
+ * A push is suppressed when it does not change the counter or replaces a
+ * value that was never flushed; the first change after a flush is written
+ * by the next one.
+ */
+static void pkt_counter_set(struct vconf_pkt_counter *pc, guint64 value)
+{
+	if (pc->value == value) {
+		key_suppressed[pc->id]++;
+		return;
 	}
-	else if (g_str_equal(key, VCONFKEY_NETWORK_CELLULAR_PKT_TOTAL_RCV) == TRUE) {
-		return STORAGE_KEY_CELLULAR_PKT_TOTAL_RCV;
+
+	if (pc->dirty)
+		key_suppressed[pc->id]++;
+
+	pc->value = value;
+	pc->dirty = TRUE;
+
+	if (!pkt_flush_timer)
+		pkt_flush_timer = g_timeout_add_seconds(pkt_flush_interval, __pkt_flush_timeout, NULL);
+}
+
+static void pkt_counter_push(struct vconf_pkt_counter *pc, int value)
+{
+	guint32 low = (guint32)pc->value;
+	guint32 v = (guint32)value;
+
+	if (!pc->total)
+		pkt_counter_set(pc, v);
+	else if (v >= low)
+		pkt_counter_set(pc, pc->value + (v - low));
+	else if (low >= G_MAXUINT32 - PKT_WRAP_MARGIN && v < PKT_WRAP_MARGIN)
+		pkt_counter_set(pc, pc->value + (guint32)(v - low));
+	else
+		pkt_counter_set(pc, v);
+}
+
+/* a change of the int key that was not written by a flush, e.g. a reset */
+static void pkt_counter_notified(enum vconf_key_id id, int value)
+{
+	struct vconf_pkt_counter *pc = pkt_counter_find(id);
+
+	if (!pc || pkt_counter_is_echo(pc, value))
+		return;
+
+	dbg("[%s] changed outside the plugin (%d)", vconf_keys[id].name, value);
+	pc->value = (guint32)value;
+	pc->dirty = TRUE;
+}
+
+static void pkt_counters_load(void)
+{
+	gchar **saved = NULL;
+	guint64 value;
+	unsigned int i;
+
+	if (key_cache_lookup(VKEY_PKT_COUNTERS))
+		saved = g_strsplit(key_cache[VKEY_PKT_COUNTERS].sval, " ", G_N_ELEMENTS(pkt_counters));
+
+	for (i = 0; i < G_N_ELEMENTS(pkt_counters); i++) {
+		struct vconf_pkt_counter *pc = &pkt_counters[i];
+		int stored = key_cache_lookup(pc->id) ? key_cache[pc->id].ival : 0;
+
+		pc->dirty = FALSE;
+		pc->flushed_count = 0;
+		pc->value = (guint32)stored;
+
+		if (!saved || g_strv_length(saved) <= i)
+			continue;
+
+		/* the int key wins if it was changed while the plugin was down */
+		value = g_ascii_strtoull(saved[i], NULL, 10);
+		if ((guint32)value == (guint32)stored)
+			pc->value = value;
 	}
-	else if (g_str_equal(key, VCONFKEY_NETWORK_CELLULAR_PKT_TOTAL_SNT) == TRUE) {
-		return STORAGE_KEY_CELLULAR_PKT_TOTAL_SNT;
+
+	g_strfreev(saved);
+}
+
+static void __pm_state_callback(keynode_t* node, void* data)
+{
+	pkt_counters_flush();
+}
+
+gboolean vconf_storage_get_int64(Storage *strg, enum tcore_storage_key key, gint64 *value)
+{
+	struct vconf_pkt_counter *pc;
+
+	if (!strg || !value || !(key & STORAGE_KEY_INT))
+		return FALSE;
+
+	pc = pkt_counter_find(convert_strgkey_to_id(key));
+	if (!pc)
+		return FALSE;
+
+	*value = pc->value;
+	return TRUE;
+}
+
+gboolean vconf_storage_set_int64(Storage *strg, enum tcore_storage_key key, gint64 value)
+{
+	struct vconf_pkt_counter *pc;
+
+	if (!strg || value < 0 || !(key & STORAGE_KEY_INT))
+		return FALSE;
+
+	pc = pkt_counter_find(convert_strgkey_to_id(key));
+	if (!pc)
+		return FALSE;
+
+	pkt_counter_set(pc, value);
+	return TRUE;
+}
+
+static gboolean set_int(Storage *strg, enum tcore_storage_key key, int value)
+{
+	enum vconf_key_id id = VKEY_MAX;
+	struct vconf_pkt_counter *pc;
+	gint64 start = metrics_begin();
+	gboolean ret = FALSE;
+
+	if(strg && (key & STORAGE_KEY_INT))
+		id = convert_strgkey_to_id(key);
+
+	if(id != VKEY_MAX && (pc = pkt_counter_find(id)) != NULL) {
+		pkt_counter_push(pc, value);
+		ret = TRUE;
 	}
-	else if (g_str_equal(key, VCONFKEY_NETWORK_CELLULAR_PKT_LAST_RCV) == TRUE) {
-		return STORAGE_KEY_CELLULAR_PKT_LAST_RCV;
+	else if(id != VKEY_MAX)
+		ret = vconf_write_int(id, value);
+
+	metrics_end(&metric_hist[METRIC_SET_INT], start);
+	return ret;
+}
+
+static gboolean set_bool(Storage *strg, enum tcore_storage_key key, gboolean value)
+{
+	enum vconf_key_id id = VKEY_MAX;
+	gint64 start = metrics_begin();
+	gboolean ret = FALSE;
+
+	if(strg && (key & STORAGE_KEY_BOOL))
+		id = convert_strgkey_to_id(key);
+
+	if(id != VKEY_MAX)
+		ret = vconf_write_bool(id, value);
+
+	metrics_end(&metric_hist[METRIC_SET_BOOL], start);
+	return ret;
+}
+
+static gboolean set_string(Storage *strg, enum tcore_storage_key key, const char *value)
+{
+	enum vconf_key_id id = VKEY_MAX;
+	gint64 start = metrics_begin();
+	gboolean ret = FALSE;
+
+	if(strg && (key & STORAGE_KEY_STRING))
+		id = convert_strgkey_to_id(key);
+
+	if(id != VKEY_MAX)
+		ret = vconf_write_str(id, value);
+
+	metrics_end(&metric_hist[METRIC_SET_STRING], start);
+	return ret;
+}
+
+static int get_int(Storage *strg, enum tcore_storage_key key)
+{
+	enum vconf_key_id id = VKEY_MAX;
+	struct vconf_pkt_counter *pc;
+	gint64 start = metrics_begin();
+	int value = -1;
+
+	if(strg && (key & STORAGE_KEY_INT))
+		id = convert_strgkey_to_id(key);
+
+	if(id != VKEY_MAX && (pc = pkt_counter_find(id)) != NULL)
+		value = (int)(guint32)pc->value;
+	else if(id != VKEY_MAX && !key_pending_int(id, &value) && key_cache_lookup(id))
+		value = key_cache[id].ival;
+
+	metrics_end(&metric_hist[METRIC_GET_INT], start);
+	return value;
+}
+
+static gboolean get_bool(Storage *strg, enum tcore_storage_key key)
+{
+	enum vconf_key_id id = VKEY_MAX;
+	gint64 start = metrics_begin();
+	gboolean value = FALSE;
+
+	if(strg && (key & STORAGE_KEY_BOOL))
+		id = convert_strgkey_to_id(key);
+
+	if(id != VKEY_MAX && key_cache_lookup(id))
+		value = key_cache[id].ival;
+
+	metrics_end(&metric_hist[METRIC_GET_BOOL], start);
+	return value;
+}
+
+static char *get_string(Storage *strg, enum tcore_storage_key key)
+{
+	enum vconf_key_id id = VKEY_MAX;
+	gint64 start = metrics_begin();
+	char *value = NULL;
+
+	if(strg && (key & STORAGE_KEY_STRING))
+		id = convert_strgkey_to_id(key);
+
+	/* callers release the result with free() */
+	if(id != VKEY_MAX && key_cache_lookup(id))
+		value = strdup(key_cache[id].sval);
+
+	metrics_end(&metric_hist[METRIC_GET_STRING], start);
+	return value;
+}
+
+/*
+ * Bulk read, served from the key cache in one pass. Only a key the cache
+ * could not load at init goes back to vconf.
+ */
+int vconf_storage_get_multi(Storage *strg, const enum tcore_storage_key *keys,
+		struct vconf_storage_value *values, unsigned int count)
+{
+	struct vconf_pkt_counter *pc;
+	enum vconf_key_id id;
+	gint64 start = metrics_begin();
+	unsigned int i;
+	int found = 0;
+
+	if (!strg || !keys || !values)
+		return -1;
+
+	for (i = 0; i < count; i++) {
+		memset(&values[i], 0, sizeof(values[i]));
+
+		id = convert_strgkey_to_id(keys[i]);
+		if (id == VKEY_MAX)
+			continue;
+
+		if ((pc = pkt_counter_find(id)) != NULL) {
+			values[i].ival = (int)(guint32)pc->value;
+			values[i].valid = TRUE;
+		}
+		else if (key_pending_int(id, &values[i].ival)) {
+			values[i].valid = TRUE;
+		}
+		else if (key_cache_lookup(id)) {
+			if (vconf_keys[id].type == VCONF_TYPE_STRING)
+				values[i].sval = strdup(key_cache[id].sval);
+			else
+				values[i].ival = key_cache[id].ival;
+			values[i].valid = TRUE;
+		}
+
+		if (values[i].valid)
+			found++;
 	}
-	else if (g_str_equal(key, VCONFKEY_NETWORK_CELLULAR_PKT_LAST_SNT) == TRUE) {
-		return STORAGE_KEY_CELLULAR_PKT_LAST_SNT;
+
+	metrics_end(&metric_hist[METRIC_GET_MULTI], start);
+	return found;
+}
+
+/*
+ * Key-change subscribers, one list per key id
+ *
+ * A subscriber is either a plain TcoreStorageDispatchCallback registered
+ * through the set_key_callback op, or a VconfStorageKeyCallback with its
+ * own user data. Registering the same subscriber again only takes another
+ * reference, so it is dispatched once and stays until the last remove.
+ * Subscribers take no vconf watch of their own: they are dispatched from
+ * the key cache's watch, so every key is watched exactly once.
+ */
+struct vconf_subscriber {
+	Storage *strg;
+	TcoreStorageDispatchCallback dispatch_cb;
+	VconfStorageKeyCallback cb;
+	void *user_data;
+	unsigned int refs;
+	gboolean removed;
+};
+
+static GSList *key_subscribers[VKEY_MAX];
+static gboolean key_dispatching[VKEY_MAX];
+static guint batch_key_refs[VKEY_MAX];
+
+static void subscriber_prune(enum vconf_key_id id)
+{
+	GSList *l, *next;
+	struct vconf_subscriber *sub;
+
+	if (!key_subscribers[id])
+		return;
+
+	for (l = key_subscribers[id]; l; l = next) {
+		next = l->next;
+		sub = l->data;
+		if (!sub->removed)
+			continue;
+
+		key_subscribers[id] = g_slist_delete_link(key_subscribers[id], l);
+		g_free(sub);
 	}
-	return 0;
 }
 
-static void* create_handle(Storage *strg, const char *path)
+static gboolean subscriber_add(Storage *strg, enum tcore_storage_key key,
+		TcoreStorageDispatchCallback dispatch_cb, VconfStorageKeyCallback cb, void *user_data)
 {
-	void *tmp = NULL;
-	if(!strg)
-		return NULL;
+	enum vconf_key_id id;
+	struct vconf_subscriber *sub;
+	GSList *l;
 
-	tmp = malloc(sizeof(char));
-	return tmp;
-}
+	if (!strg)
+		return FALSE;
 
-static gboolean remove_handle(Storage *strg, void *handle)
-{
-	if(!strg || !handle)
+	id = convert_strgkey_to_id(key);
+	dbg("s_key (%s)", id == VKEY_MAX ? NULL : vconf_keys[id].name);
+
+	if (id == VKEY_MAX)
 		return FALSE;
 
-	free(handle);
+	for (l = key_subscribers[id]; l; l = l->next) {
+		sub = l->data;
+		if (!sub->removed && sub->strg == strg && sub->dispatch_cb == dispatch_cb
+				&& sub->cb == cb && sub->user_data == user_data) {
+			sub->refs++;
+			return TRUE;
+		}
+	}
+
+	sub = g_new0(struct vconf_subscriber, 1);
+	sub->strg = strg;
+	sub->dispatch_cb = dispatch_cb;
+	sub->cb = cb;
+	sub->user_data = user_data;
+	sub->refs = 1;
+	key_subscribers[id] = g_slist_append(key_subscribers[id], sub);
+
 	return TRUE;
 }
 
-static gboolean set_int(Storage *strg, enum tcore_storage_key key, int value)
+/*
+ * With dispatch set, drops every set_key_callback subscriber of strg (the
+ * op has no callback argument); otherwise drops one reference of the
+ * matching cb/user_data subscriber.
+ */
+static gboolean subscriber_remove(Storage *strg, enum tcore_storage_key key,
+		gboolean dispatch, VconfStorageKeyCallback cb, void *user_data)
 {
-	const gchar *s_key = NULL;
+	enum vconf_key_id id;
+	struct vconf_subscriber *sub;
+	GSList *l;
 
 	if (!strg)
 		return FALSE;
 
-	if(key & STORAGE_KEY_INT)
-		s_key = convert_strgkey_to_vconf(key);
+	id = convert_strgkey_to_id(key);
+	dbg("s_key (%s)", id == VKEY_MAX ? NULL : vconf_keys[id].name);
 
-	if(!s_key)
+	if (id == VKEY_MAX)
 		return FALSE;
 
-	vconf_set_int(s_key, value);
+	for (l = key_subscribers[id]; l; l = l->next) {
+		sub = l->data;
+		if (sub->removed || sub->strg != strg)
+			continue;
+
+		if (dispatch && sub->dispatch_cb)
+			sub->removed = TRUE;
+		else if (!dispatch && sub->cb == cb && sub->user_data == user_data && --sub->refs == 0)
+			sub->removed = TRUE;
+	}
+
+	if (!key_dispatching[id])
+		subscriber_prune(id);
+
 	return TRUE;
 }
 
-static gboolean set_bool(Storage *strg, enum tcore_storage_key key, gboolean value)
+/*
+ * Batch subscribers ([general] dispatch_window, opt-in per subscriber)
+ *
+ * Changes of the keys a batch subscriber registered are collected until
+ * the next main-loop iteration, or for dispatch_window ms, and handed
+ * over as one array. A key that changes again before the dispatch only
+ * keeps its latest value.
+ */
+struct vconf_batch_subscriber {
+	Storage *strg;
+	VconfStorageBatchCallback cb;
+	void *user_data;
+	gboolean keys[VKEY_MAX];
+	gboolean removed;
+};
+
+static GSList *batch_subscribers;
+static gboolean batch_dispatching;
+
+static GVariant *pending_change[VKEY_MAX];
+static enum vconf_key_id pending_order[VKEY_MAX];
+static unsigned int pending_count;
+static guint pending_source;
+
+static guint dispatch_window;		/* ms, 0: next main-loop iteration */
+static guint batch_dispatches;
+static guint collapsed_dispatches;
+
+static struct vconf_batch_subscriber *batch_subscriber_find(Storage *strg,
+		VconfStorageBatchCallback cb, void *user_data)
 {
-	const gchar *s_key = NULL;
+	struct vconf_batch_subscriber *sub;
+	GSList *l;
 
-	if (!strg)
-		return FALSE;
+	for (l = batch_subscribers; l; l = l->next) {
+		sub = l->data;
+		if (!sub->removed && sub->strg == strg && sub->cb == cb && sub->user_data == user_data)
+			return sub;
+	}
+
+	return NULL;
+}
 
-	if(key & STORAGE_KEY_BOOL)
-		s_key = convert_strgkey_to_vconf(key);
+static void batch_subscriber_prune(void)
+{
+	struct vconf_batch_subscriber *sub;
+	GSList *l, *next;
 
-	if(!s_key)
-		return FALSE;
+	for (l = batch_subscribers; l; l = next) {
+		next = l->next;
+		sub = l->data;
+		if (!sub->removed)
+			continue;
 
-	vconf_set_bool(s_key, value);
-	return TRUE;
+		batch_subscribers = g_slist_delete_link(batch_subscribers, l);
+		g_free(sub);
+	}
 }
 
-static gboolean set_string(Storage *strg, enum tcore_storage_key key, const char *value)
+static void batch_subscriber_drop(struct vconf_batch_subscriber *sub)
 {
-	const gchar *s_key = NULL;
+	int i;
 
-	if (!strg)
-		return FALSE;
+	for (i = 0; i < VKEY_MAX; i++) {
+		if (!sub->keys[i])
+			continue;
 
-	if(key & STORAGE_KEY_STRING)
-		s_key = convert_strgkey_to_vconf(key);
+		sub->keys[i] = FALSE;
+		batch_key_refs[i]--;
+	}
 
-	if(!s_key)
-		return FALSE;
+	sub->removed = TRUE;
+}
 
-	vconf_set_str(s_key, value);
-	return TRUE;
+static gboolean __batch_dispatch(gpointer user_data)
+{
+	struct vconf_storage_change changes[VKEY_MAX];
+	struct vconf_storage_change mine[VKEY_MAX];
+	enum vconf_key_id ids[VKEY_MAX];
+	struct vconf_batch_subscriber *sub;
+	unsigned int count, i, n;
+	GSList *l;
+
+	pending_source = 0;
+
+	count = pending_count;
+	for (i = 0; i < count; i++) {
+		ids[i] = pending_order[i];
+		changes[i].key = vconf_keys[ids[i]].strg_key;
+		changes[i].value = pending_change[ids[i]];
+		pending_change[ids[i]] = NULL;
+	}
+	pending_count = 0;
+
+	batch_dispatching = TRUE;
+	for (l = batch_subscribers; l; l = l->next) {
+		sub = l->data;
+		if (sub->removed)
+			continue;
+
+		for (i = 0, n = 0; i < count; i++) {
+			if (sub->keys[ids[i]])
+				mine[n++] = changes[i];
+		}
+
+		if (!n)
+			continue;
+
+		sub->cb(sub->strg, mine, n, sub->user_data);
+		batch_dispatches++;
+		collapsed_dispatches += n - 1;
+	}
+	batch_dispatching = FALSE;
+
+	batch_subscriber_prune();
+
+	for (i = 0; i < count; i++)
+		g_variant_unref(changes[i].value);
+
+	return FALSE;
 }
 
-static int get_int(Storage *strg, enum tcore_storage_key key)
+static void batch_pend(enum vconf_key_id id, GVariant *value)
 {
-	int value = -1;
-	const gchar *s_key = NULL;
+	if (pending_change[id]) {
+		g_variant_unref(pending_change[id]);
+		collapsed_dispatches++;
+	}
+	else {
+		pending_order[pending_count++] = id;
+	}
 
-	if (!strg)
-		return value;
+	pending_change[id] = g_variant_ref(value);
+
+	if (pending_source)
+		return;
+
+	if (dispatch_window)
+		pending_source = g_timeout_add(dispatch_window, __batch_dispatch, NULL);
+	else
+		pending_source = g_idle_add(__batch_dispatch, NULL);
+}
 
-	if(key & STORAGE_KEY_INT)
-		s_key = convert_strgkey_to_vconf(key);
+static void subscriber_free_all(void)
+{
+	unsigned int i;
+	GSList *l;
 
-	if(s_key != NULL)
-		vconf_get_int(s_key, &value);
+	for (i = 0; i < VKEY_MAX; i++) {
+		for (l = key_subscribers[i]; l; l = l->next)
+			((struct vconf_subscriber *)l->data)->removed = TRUE;
 
-	return value;
+		subscriber_prune(i);
+	}
+
+	for (l = batch_subscribers; l; l = l->next)
+		batch_subscriber_drop(l->data);
+	batch_subscriber_prune();
+
+	if (pending_source)
+		g_source_remove(pending_source);
+	pending_source = 0;
+
+	for (i = 0; i < pending_count; i++) {
+		g_variant_unref(pending_change[pending_order[i]]);
+		pending_change[pending_order[i]] = NULL;
+	}
+	pending_count = 0;
+
+	dbg("dispatch: batched(%u) collapsed(%u)", batch_dispatches, collapsed_dispatches);
 }
 
-static gboolean get_bool(Storage *strg, enum tcore_storage_key key)
+/*
+ * Values handed to key-change subscribers
+ *
+ * Subscribers only borrow the value, so immutable variants are shared:
+ * booleans and small ints come from fixed tables, repeated strings
+ * (network names, ...) from a bounded table, and anything else is kept
+ * per key and reused while the value does not change.
+ */
+#define VARIANT_INT_MIN (-1)
+#define VARIANT_INT_MAX 255
+#define VARIANT_STR_MAX 64
+
+static GVariant *variant_bool[2];
+static GVariant *variant_int[VARIANT_INT_MAX - VARIANT_INT_MIN + 1];
+static GHashTable *variant_str;
+static GVariant *key_variant[VKEY_MAX];
+static guint variant_allocs;
+
+static GVariant *variant_new(GVariant *value)
 {
-	gboolean value = FALSE;
-	const gchar *s_key = NULL;
+	variant_allocs++;
+	return g_variant_ref_sink(value);
+}
 
-	if (!strg)
-		return value;
+static void variant_keep(enum vconf_key_id id, GVariant *value)
+{
+	if (key_variant[id])
+		g_variant_unref(key_variant[id]);
 
-	if(key & STORAGE_KEY_BOOL)
-		s_key = convert_strgkey_to_vconf(key);
+	key_variant[id] = value;
+}
 
-	if(s_key != NULL)
-		vconf_get_bool(s_key, &value);
+static GVariant *variant_get_int(enum vconf_key_id id, gint32 v)
+{
+	GVariant **slot;
 
-	return value;
+	if (v >= VARIANT_INT_MIN && v <= VARIANT_INT_MAX) {
+		slot = &variant_int[v - VARIANT_INT_MIN];
+		if (!*slot)
+			*slot = variant_new(g_variant_new_int32(v));
+
+		return *slot;
+	}
+
+	if (key_variant[id] && g_variant_is_of_type(key_variant[id], G_VARIANT_TYPE_INT32)
+			&& g_variant_get_int32(key_variant[id]) == v)
+		return key_variant[id];
+
+	variant_keep(id, variant_new(g_variant_new_int32(v)));
+	return key_variant[id];
 }
 
-static char *get_string(Storage *strg, enum tcore_storage_key key)
+static GVariant *variant_get_str(enum vconf_key_id id, const gchar *v)
 {
-	const gchar *s_key = NULL;
+	GVariant *value;
 
-	if (!strg)
+	if (!v)
 		return NULL;
 
-	if(key & STORAGE_KEY_STRING)
-		s_key = convert_strgkey_to_vconf(key);
+	if (key_variant[id] && g_variant_is_of_type(key_variant[id], G_VARIANT_TYPE_STRING)
+			&& g_strcmp0(g_variant_get_string(key_variant[id], NULL), v) == 0)
+		return key_variant[id];
+
+	if (!variant_str)
+		variant_str = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+				(GDestroyNotify)g_variant_unref);
+
+	value = g_hash_table_lookup(variant_str, v);
+	if (value)
+		return value;
+
+	value = variant_new(g_variant_new_string(v));
+	if (g_hash_table_size(variant_str) < VARIANT_STR_MAX) {
+		g_hash_table_insert(variant_str, g_strdup(v), value);
+		return value;
+	}
+
+	variant_keep(id, value);
+	return value;
+}
+
+static GVariant *variant_get(enum vconf_key_id id, keynode_t *node)
+{
+	gboolean b;
+
+	switch (vconf_keynode_get_type(node)) {
+		case VCONF_TYPE_STRING:
+			return variant_get_str(id, vconf_keynode_get_str(node));
+
+		case VCONF_TYPE_INT:
+			return variant_get_int(id, vconf_keynode_get_int(node));
+
+		case VCONF_TYPE_BOOL:
+			b = vconf_keynode_get_bool(node) ? TRUE : FALSE;
+			if (!variant_bool[b])
+				variant_bool[b] = variant_new(g_variant_new_boolean(b));
+			return variant_bool[b];
 
-	if(s_key != NULL)
-		return vconf_get_str(s_key);
+		case VCONF_TYPE_DOUBLE:
+			variant_keep(id, variant_new(g_variant_new_double(vconf_keynode_get_dbl(node))));
+			return key_variant[id];
+
+		default:
+			break;
+	}
 
 	return NULL;
 }
 
-static void __vconfkey_callback(keynode_t* node, void* data)
+static void variant_free_all(void)
 {
-	int type = 0;
-	char *vkey = NULL;
-	GVariant *value = NULL;
-	enum tcore_storage_key s_key = 0;
-	Storage *strg = NULL;
+	unsigned int i;
 
-	strg = (Storage *)data;
-	vkey = vconf_keynode_get_name(node);
-	type = vconf_keynode_get_type(node);
-	s_key = convert_vconf_to_strgkey(vkey);
+	dbg("dispatch: variant allocations(%u)", variant_allocs);
 
-	if(type == VCONF_TYPE_STRING){
-		gchar *tmp;
-		tmp = (gchar *)vconf_keynode_get_str(node);
-		value = g_variant_new_string( tmp );
+	for (i = 0; i < G_N_ELEMENTS(variant_bool); i++) {
+		if (variant_bool[i])
+			g_variant_unref(variant_bool[i]);
+		variant_bool[i] = NULL;
 	}
-	else if(type == VCONF_TYPE_INT){
-		gint32 tmp = 0;
-		tmp = vconf_keynode_get_int(node);
-		value = g_variant_new_int32( tmp );
+
+	for (i = 0; i < G_N_ELEMENTS(variant_int); i++) {
+		if (variant_int[i])
+			g_variant_unref(variant_int[i]);
+		variant_int[i] = NULL;
 	}
-	else if(type == VCONF_TYPE_DOUBLE){
-		gdouble tmp = 0;
-		tmp = vconf_keynode_get_dbl(node);
-		value = g_variant_new_double( tmp );
+
+	for (i = 0; i < VKEY_MAX; i++)
+		variant_keep(i, NULL);
+
+	if (variant_str) {
+		g_hash_table_destroy(variant_str);
+		variant_str = NULL;
 	}
-	else if(type == VCONF_TYPE_BOOL){
-		gboolean tmp = FALSE;
-		tmp = vconf_keynode_get_bool(node);
-		value = g_variant_new_boolean( tmp );
+}
+
+static void key_dispatch(keynode_t *node, enum vconf_key_id id)
+{
+	const char *vkey = vconf_keys[id].name;
+	GVariant *value = NULL;
+	enum tcore_storage_key s_key = 0;
+	struct vconf_subscriber *sub;
+	guint32 size = sizeof(int);
+	GSList *l;
+
+	if (!key_subscribers[id] && !batch_key_refs[id])
+		return;
+
+	s_key = vconf_keys[id].strg_key;
+
+	value = variant_get(id, node);
+	if (!value) {
+		dbg("[%s] unsupported type(%d), not dispatched", vkey, vconf_keynode_get_type(node));
+		return;
 	}
 
+	if (vconf_keynode_get_type(node) == VCONF_TYPE_STRING)
+		size = strlen(vconf_keynode_get_str(node)) + 1;
+	vconf_trace_begin(VCONF_TRACE_CALLBACK, vconf_keys[id].name, 1, size, key_cause[id]);
+
+	if (batch_key_refs[id])
+		batch_pend(id, value);
 
-	if(callback_dispatch != NULL)
-		callback_dispatch(strg, s_key, value);
+	key_dispatching[id] = TRUE;
+	for (l = key_subscribers[id]; l; l = l->next) {
+		sub = l->data;
+		if (sub->removed)
+			continue;
 
-	return;
+		if (sub->cb)
+			sub->cb(sub->strg, s_key, value, sub->user_data);
+		else
+			sub->dispatch_cb(sub->strg, s_key, value);
+	}
+	key_dispatching[id] = FALSE;
+
+	subscriber_prune(id);
+
+	vconf_trace_end(VCONF_TRACE_CALLBACK, vconf_keys[id].name, 1, size, key_cause[id]);
 }
 
 static gboolean set_key_callback(Storage *strg, enum tcore_storage_key key, TcoreStorageDispatchCallback cb)
 {
-	const gchar *s_key = NULL;
+	if (!cb)
+		return FALSE;
 
-	if (!strg)
+	return subscriber_add(strg, key, cb, NULL, NULL);
+}
+
+static gboolean remove_key_callback(Storage *strg, enum tcore_storage_key key)
+{
+	return subscriber_remove(strg, key, TRUE, NULL, NULL);
+}
+
+gboolean vconf_storage_add_key_callback(Storage *strg, enum tcore_storage_key key, VconfStorageKeyCallback cb, void *user_data)
+{
+	if (!cb)
 		return FALSE;
 
-	s_key = convert_strgkey_to_vconf(key);
-	dbg("s_key (%s)", s_key);
+	return subscriber_add(strg, key, NULL, cb, user_data);
+}
 
-	if(s_key == NULL)
+gboolean vconf_storage_remove_key_callback(Storage *strg, enum tcore_storage_key key, VconfStorageKeyCallback cb, void *user_data)
+{
+	if (!cb)
 		return FALSE;
 
-	if(callback_dispatch == NULL)
-		callback_dispatch = cb;
+	return subscriber_remove(strg, key, FALSE, cb, user_data);
+}
 
-	vconf_notify_key_changed(s_key, __vconfkey_callback, strg);
-	return TRUE;
+int vconf_storage_add_key_callbacks(Storage *strg, const enum tcore_storage_key *keys, unsigned int count,
+		VconfStorageKeyCallback cb, void *user_data)
+{
+	unsigned int i;
+	int added = 0;
+
+	if (!cb || !keys)
+		return 0;
+
+	for (i = 0; i < count; i++) {
+		if (subscriber_add(strg, keys[i], NULL, cb, user_data))
+			added++;
+	}
+
+	dbg("%d/%u keys subscribed, %u watches active", added, count, active_watches);
+	return added;
 }
 
-static gboolean remove_key_callback(Storage *strg, enum tcore_storage_key key)
+int vconf_storage_remove_key_callbacks(Storage *strg, const enum tcore_storage_key *keys, unsigned int count,
+		VconfStorageKeyCallback cb, void *user_data)
 {
-	const gchar *s_key = NULL;
+	unsigned int i;
+	int removed = 0;
 
-	if (!strg)
-		return FALSE;
+	if (!cb || !keys)
+		return 0;
 
-	s_key = convert_strgkey_to_vconf(key);
-	dbg("s_key (%s)", s_key);
+	for (i = 0; i < count; i++) {
+		if (subscriber_remove(strg, keys[i], FALSE, cb, user_data))
+			removed++;
+	}
+
+	return removed;
+}
+
+unsigned int vconf_storage_active_watches(void)
+{
+	return active_watches;
+}
+
+int vconf_storage_add_batch_callback(Storage *strg, const enum tcore_storage_key *keys, unsigned int count,
+		VconfStorageBatchCallback cb, void *user_data)
+{
+	struct vconf_batch_subscriber *sub;
+	enum vconf_key_id id;
+	unsigned int i;
+	int added = 0;
+
+	if (!strg || !cb || !keys)
+		return 0;
+
+	sub = batch_subscriber_find(strg, cb, user_data);
+	if (!sub) {
+		sub = g_new0(struct vconf_batch_subscriber, 1);
+		sub->strg = strg;
+		sub->cb = cb;
+		sub->user_data = user_data;
+		batch_subscribers = g_slist_append(batch_subscribers, sub);
+	}
+
+	for (i = 0; i < count; i++) {
+		id = convert_strgkey_to_id(keys[i]);
+		if (id == VKEY_MAX)
+			continue;
+
+		added++;
+		if (sub->keys[id])
+			continue;
+
+		sub->keys[id] = TRUE;
+		batch_key_refs[id]++;
+	}
+
+	return added;
+}
+
+gboolean vconf_storage_remove_batch_callback(Storage *strg, VconfStorageBatchCallback cb, void *user_data)
+{
+	struct vconf_batch_subscriber *sub;
 
-	if(s_key == NULL)
+	sub = batch_subscriber_find(strg, cb, user_data);
+	if (!sub)
 		return FALSE;
 
-	vconf_ignore_key_changed(s_key, __vconfkey_callback);
+	batch_subscriber_drop(sub);
+	if (!batch_dispatching)
+		batch_subscriber_prune();
+
 	return TRUE;
 }
 
+unsigned int vconf_storage_collapsed_dispatches(void)
+{
+	return collapsed_dispatches;
+}
+
 struct storage_operations ops = {
 	.create_handle = create_handle,
 	.remove_handle = remove_handle,
@@ -504,50 +2130,258 @@ struct storage_operations ops = {
 	.remove_key_callback = remove_key_callback,
 };
 
+/*
+ * "vconf-shm" storage: volatile keys are read from the shared-memory
+ * mirror, everything else (writes, persistent db/ keys, key callbacks,
+ * strings too long for a slot) goes through the "vconf" storage ops,
+ * which keep the mirror updated.
+ */
+static int shm_get_int(Storage *strg, enum tcore_storage_key key)
+{
+	enum vconf_key_id id = convert_strgkey_to_id(key);
+	int value;
+
+	if (strg && id != VKEY_MAX && key_shm_slot[id] >= 0 && (key & STORAGE_KEY_INT)
+			&& !key_pending_int(id, &value) && vconf_shm_writer_get_int(key_shm_slot[id], &value))
+		return value;
+
+	return get_int(strg, key);
+}
+
+static gboolean shm_get_bool(Storage *strg, enum tcore_storage_key key)
+{
+	enum vconf_key_id id = convert_strgkey_to_id(key);
+	int value;
+
+	if (strg && id != VKEY_MAX && key_shm_slot[id] >= 0 && (key & STORAGE_KEY_BOOL)
+			&& vconf_shm_writer_get_int(key_shm_slot[id], &value))
+		return value;
+
+	return get_bool(strg, key);
+}
+
+static char *shm_get_string(Storage *strg, enum tcore_storage_key key)
+{
+	enum vconf_key_id id = convert_strgkey_to_id(key);
+	char *value = NULL;
+
+	if (strg && id != VKEY_MAX && key_shm_slot[id] >= 0 && (key & STORAGE_KEY_STRING))
+		value = vconf_shm_writer_get_str(key_shm_slot[id]);
+
+	if (!value)
+		value = get_string(strg, key);
+
+	return value;
+}
+
+struct storage_operations shm_ops = {
+	.create_handle = create_handle,
+	.remove_handle = remove_handle,
+	.set_int = set_int,
+	.set_string = set_string,
+	.set_bool = set_bool,
+	.get_int = shm_get_int,
+	.get_string = shm_get_string,
+	.get_bool = shm_get_bool,
+	.set_key_callback = set_key_callback,
+	.remove_key_callback = remove_key_callback,
+};
+
+/*
+ * Last network name resolution
+ *
+ * tcore gives no change signal for the NITZ/SPN names, so they are
+ * fetched on every call and compared. When the PLMN, service type, name
+ * priority and names all match, the operator table lookup is skipped
+ * and the memoized result is republished (the write path drops it unless
+ * another hook has overwritten the keys in between). Hits and misses are
+ * part of the metrics dump.
+ */
+struct network_name_memo {
+	gboolean valid;
+	CoreObject *o;
+	gchar *plmn;
+	enum telephony_network_service_type svc_type;
+	enum tcore_network_name_priority priority;
+	gchar *spn;
+	gchar *full;
+	gchar *shrt;
+
+	int disp_condition;
+	gchar *nwname;
+};
+
+static struct network_name_memo name_memo;
+static guint name_memo_hits;
+static guint name_memo_misses;
+
+static void network_name_memo_clear(void)
+{
+	g_free(name_memo.plmn);
+	g_free(name_memo.spn);
+	g_free(name_memo.full);
+	g_free(name_memo.shrt);
+	g_free(name_memo.nwname);
+	name_memo.plmn = name_memo.spn = name_memo.full = name_memo.shrt = name_memo.nwname = NULL;
+	name_memo.valid = FALSE;
+}
+
+static void network_name_memo_free(void)
+{
+	dbg("network name: hits(%u) misses(%u)", name_memo_hits, name_memo_misses);
+	network_name_memo_clear();
+}
+
+static gboolean network_name_memo_lookup(CoreObject *o, const char *plmn,
+		enum telephony_network_service_type svc_type, enum tcore_network_name_priority priority,
+		const char *spn, const char *full, const char *shrt)
+{
+	if (name_memo.valid && name_memo.o == o
+			&& g_strcmp0(name_memo.spn, spn) == 0
+			&& g_strcmp0(name_memo.full, full) == 0
+			&& g_strcmp0(name_memo.shrt, shrt) == 0
+			&& g_strcmp0(name_memo.plmn, plmn) == 0
+			&& name_memo.svc_type == svc_type && name_memo.priority == priority) {
+		name_memo_hits++;
+		return TRUE;
+	}
+
+	name_memo_misses++;
+
+	network_name_memo_clear();
+	name_memo.o = o;
+	name_memo.plmn = g_strdup(plmn);
+	name_memo.svc_type = svc_type;
+	name_memo.priority = priority;
+	name_memo.spn = g_strdup(spn);
+	name_memo.full = g_strdup(full);
+	name_memo.shrt = g_strdup(shrt);
+
+	return FALSE;
+}
+
+/*
+ * Without an index file, on_init builds the index from mcc_mnc_oper_list
+ * through the "database" storage, so name lookups never do I/O.
+ */
+static gboolean operator_index_load_db(Server *s)
+{
+	struct vconf_operator_row row;
+	Storage *db;
+	void *handle;
+	GHashTable *result;
+	GHashTableIter iter;
+	gpointer value;
+	GArray *rows;
+	gchar *data;
+	gsize size;
+	gboolean loaded;
+
+	db = tcore_server_find_storage(s, "database");
+	if (!db)
+		return FALSE;
+
+	handle = tcore_storage_create_handle(db, VCONF_OPERATOR_DB_PATH);
+	if (!handle) {
+		err("failed to open %s", VCONF_OPERATOR_DB_PATH);
+		return FALSE;
+	}
+
+	result = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_hash_table_destroy);
+	tcore_storage_read_query_database(db, handle, VCONF_OPERATOR_DB_QUERY, NULL, result, 4);
+	tcore_storage_remove_handle(db, handle);
+
+	/* each row maps the column numbers "0".."3" to their values */
+	rows = g_array_sized_new(FALSE, FALSE, sizeof(struct vconf_operator_row), g_hash_table_size(result));
+	g_hash_table_iter_init(&iter, result);
+	while (g_hash_table_iter_next(&iter, NULL, &value)) {
+		row.country = g_hash_table_lookup(value, "0");
+		row.mcc = g_hash_table_lookup(value, "1");
+		row.mnc = g_hash_table_lookup(value, "2");
+		row.name = g_hash_table_lookup(value, "3");
+		g_array_append_val(rows, row);
+	}
+
+	data = vconf_operator_index_build((const struct vconf_operator_row *)rows->data, rows->len, &size);
+	loaded = vconf_operator_index_load(data, size);
+	if (!loaded)
+		g_free(data);
+	else
+		dbg("operator index: %u rows from %s", rows->len, VCONF_OPERATOR_DB_PATH);
+
+	g_array_free(rows, TRUE);
+	g_hash_table_destroy(result);
+
+	return loaded;
+}
+
 static void _update_vconf_network_name(CoreObject *o, const char *plmn)
 {
-	struct tcore_network_operator_info *noi = NULL;
-	char *tmp;
+	const char *country = NULL;
 	enum telephony_network_service_type svc_type;
 	enum tcore_network_name_priority network_name_priority;
 	char mcc[4] = { 0, };
 	char mnc[4] = { 0, };
 	char *plmn_str = NULL;
+	char *spn = NULL;
+	char *full = NULL;
+	char *shrt = NULL;
+	const char *nwname = NULL;
+	int disp_condition;
 
 	if (plmn)
 		plmn_str = (char *)plmn;
 	else
 		plmn_str = tcore_network_get_plmn(o);
 
-	if (plmn_str) {
-		snprintf(mcc, 4, "%s", plmn_str);
-		snprintf(mnc, 4, "%s", plmn_str+3);
+	tcore_network_get_service_type(o, &svc_type);
+	tcore_network_get_network_name_priority(o, &network_name_priority);
+
+	switch (svc_type) {
+		case NETWORK_SERVICE_TYPE_2G:
+		case NETWORK_SERVICE_TYPE_2_5G:
+		case NETWORK_SERVICE_TYPE_2_5G_EDGE:
+		case NETWORK_SERVICE_TYPE_3G:
+		case NETWORK_SERVICE_TYPE_HSDPA:
+			spn = tcore_network_get_network_name(o, TCORE_NETWORK_NAME_TYPE_SPN);
+			full = tcore_network_get_network_name(o, TCORE_NETWORK_NAME_TYPE_FULL);
+			if (!full)
+				shrt = tcore_network_get_network_name(o, TCORE_NETWORK_NAME_TYPE_SHORT);
+			break;
 
-		if (mnc[2] == '#')
-			mnc[2] = '\0';
+		default:
+			break;
 	}
 
-	tcore_network_get_service_type(o, &svc_type);
+	if (network_name_memo_lookup(o, plmn_str, svc_type, network_name_priority, spn, full, shrt)) {
+		vconf_write_int(VKEY_SPN_DISP_CONDITION, name_memo.disp_condition);
+		if (spn)
+			vconf_write_str(VKEY_SPN_NAME, spn);
+		if (name_memo.nwname)
+			vconf_write_str(VKEY_NWNAME, name_memo.nwname);
+		goto out;
+	}
 
-	tcore_network_get_network_name_priority(o, &network_name_priority);
 	switch (network_name_priority) {
 		case TCORE_NETWORK_NAME_PRIORITY_SPN:
-			vconf_set_int(VCONFKEY_TELEPHONY_SPN_DISP_CONDITION, VCONFKEY_TELEPHONY_DISP_SPN);
+			disp_condition = VCONFKEY_TELEPHONY_DISP_SPN;
 			break;
 
 		case TCORE_NETWORK_NAME_PRIORITY_NETWORK:
-			vconf_set_int(VCONFKEY_TELEPHONY_SPN_DISP_CONDITION, VCONFKEY_TELEPHONY_DISP_PLMN);
+			disp_condition = VCONFKEY_TELEPHONY_DISP_PLMN;
 			break;
 
 		case TCORE_NETWORK_NAME_PRIORITY_ANY:
-			vconf_set_int(VCONFKEY_TELEPHONY_SPN_DISP_CONDITION, VCONFKEY_TELEPHONY_DISP_SPN_PLMN);
+			disp_condition = VCONFKEY_TELEPHONY_DISP_SPN_PLMN;
 			break;
 
 		default:
-			vconf_set_int(VCONFKEY_TELEPHONY_SPN_DISP_CONDITION, VCONFKEY_TELEPHONY_DISP_INVALID);
+			disp_condition = VCONFKEY_TELEPHONY_DISP_INVALID;
 			break;
 	}
 
+	vconf_write_int(VKEY_SPN_DISP_CONDITION, disp_condition);
+
 	switch (svc_type) {
 		case NETWORK_SERVICE_TYPE_2G:
 		case NETWORK_SERVICE_TYPE_2_5G:
@@ -555,41 +2389,40 @@ static void _update_vconf_network_name(CoreObject *o, const char *plmn)
 		case NETWORK_SERVICE_TYPE_3G:
 		case NETWORK_SERVICE_TYPE_HSDPA:
 			/* spn */
-			tmp = tcore_network_get_network_name(o, TCORE_NETWORK_NAME_TYPE_SPN);
-			if (tmp) {
-				dbg("SPN[%s]", tmp);
-				vconf_set_str(VCONFKEY_TELEPHONY_SPN_NAME, tmp);
-				free(tmp);
+			if (spn) {
+				dbg("SPN[%s]", spn);
+				vconf_write_str(VKEY_SPN_NAME, spn);
 			}
 
 			/* nitz */
-			tmp = tcore_network_get_network_name(o, TCORE_NETWORK_NAME_TYPE_FULL);
-			if (tmp) {
-				dbg("NWNAME = NITZ_FULL[%s]", tmp);
-				vconf_set_str(VCONFKEY_TELEPHONY_NWNAME, tmp);
-				free(tmp);
+			if (full) {
+				dbg("NWNAME = NITZ_FULL[%s]", full);
+				nwname = full;
 				break;
 			}
-			else {
-				tmp = tcore_network_get_network_name(o, TCORE_NETWORK_NAME_TYPE_SHORT);
-				if (tmp) {
-					dbg("NWNAME = NITZ_SHORT[%s]", tmp);
-					vconf_set_str(VCONFKEY_TELEPHONY_NWNAME, tmp);
-					free(tmp);
-					break;
-				}
+			else if (shrt) {
+				dbg("NWNAME = NITZ_SHORT[%s]", shrt);
+				nwname = shrt;
+				break;
+			}
+
+			if (plmn_str) {
+				snprintf(mcc, 4, "%s", plmn_str);
+				snprintf(mnc, 4, "%s", plmn_str+3);
+
+				if (mnc[2] == '#')
+					mnc[2] = '\0';
 			}
 
-			/* pre-define table */
-			noi = tcore_network_operator_info_find(o, mcc, mnc);
-			if (noi) {
-				dbg("%s-%s: country=[%s], oper=[%s]", mcc, mnc, noi->country, noi->name);
-				dbg("NWNAME = pre-define table[%s]", noi->name);
-				vconf_set_str(VCONFKEY_TELEPHONY_NWNAME, noi->name);
+			/* the index is in memory; an unknown PLMN shows as itself */
+			nwname = vconf_operator_index_find(mcc, mnc, &country);
+			if (nwname) {
+				dbg("%s-%s: country=[%s], oper=[%s]", mcc, mnc, country, nwname);
+				dbg("NWNAME = operator index[%s]", nwname);
 			}
 			else {
 				dbg("%s-%s: no network operator name", mcc, mnc);
-				vconf_set_str(VCONFKEY_TELEPHONY_NWNAME, plmn_str);
+				nwname = plmn_str;
 			}
 			break;
 
@@ -597,98 +2430,263 @@ static void _update_vconf_network_name(CoreObject *o, const char *plmn)
 			break;
 	}
 
+	if (nwname)
+		vconf_write_str(VKEY_NWNAME, nwname);
+
+	name_memo.disp_condition = disp_condition;
+	name_memo.nwname = g_strdup(nwname);
+	name_memo.valid = TRUE;
+
+out:
+	free(spn);
+	free(full);
+	free(shrt);
+
 	if (!plmn)
 		free(plmn_str);
 }
 
-static enum tcore_hook_return on_hook_network_location_cellinfo(Server *s, CoreObject *source, enum tcore_notification_command command, unsigned int data_len, void *data, void *user_data)
+/*
+ * Network notifications of one handover (NETWORK_CHANGE,
+ * REGISTRATION_STATUS, LOCATION_CELLINFO) arrive back to back. Their
+ * hooks only record the latest data per modem; one reconcile pass per
+ * main-loop iteration then publishes the result in a single stage, so
+ * the network name is derived once and LAC is written once.
+ */
+struct network_pending {
+	Server *s;
+	CoreObject *co;
+	gboolean have_change;
+	struct tnoti_network_change change;
+	gboolean have_status;
+	struct tnoti_network_registration_status status;
+	gboolean have_cellid;
+	unsigned int cell_id;
+	gboolean have_lac;
+	unsigned int lac;	/* latest of NETWORK_CHANGE and LOCATION_CELLINFO */
+	guint32 change_flow;	/* trace flows of the notifications */
+	guint32 status_flow;
+	guint32 cellinfo_flow;
+};
+
+static GSList *network_pending_list;
+static guint network_reconcile_source;
+
+static gboolean __network_reconcile(gpointer user_data);
+
+static struct network_pending *network_pending_get(Server *s, CoreObject *co)
 {
-	const struct tnoti_network_location_cellinfo *info = data;
+	struct network_pending *np;
+	GSList *l;
 
-	dbg("vconf set");
+	for (l = network_pending_list; l; l = l->next) {
+		np = l->data;
+		if (np->co == co)
+			return np;
+	}
 
-	vconf_set_int(VCONFKEY_TELEPHONY_CELLID, info->cell_id);
-	vconf_set_int(VCONFKEY_TELEPHONY_LAC, info->lac);
+	np = g_new0(struct network_pending, 1);
+	np->s = s;
+	np->co = co;
+	network_pending_list = g_slist_append(network_pending_list, np);
 
-	return TCORE_HOOK_RETURN_CONTINUE;
+	if (!network_reconcile_source)
+		network_reconcile_source = g_idle_add(__network_reconcile, NULL);
+
+	return np;
 }
 
-static enum tcore_hook_return on_hook_network_icon_info(Server *s, CoreObject *source, enum tcore_notification_command command, unsigned int data_len, void *data, void *user_data)
+static void network_pending_clear(void)
 {
-	const struct tnoti_network_icon_info *info = data;
+	if (network_reconcile_source)
+		g_source_remove(network_reconcile_source);
+	network_reconcile_source = 0;
+
+	g_slist_free_full(network_pending_list, g_free);
+	network_pending_list = NULL;
+}
 
-	vconf_set_int(VCONFKEY_TELEPHONY_RSSI, info->rssi);
+/* the modem may have been removed between its hooks and the reconcile */
+static gboolean network_pending_alive(struct network_pending *np)
+{
+	GSList *p;
 
-	return TCORE_HOOK_RETURN_CONTINUE;
+	for (p = tcore_server_ref_plugins(np->s); p; p = p->next) {
+		if (g_slist_find(tcore_plugin_ref_core_objects(p->data), np->co))
+			return TRUE;
+	}
+
+	return FALSE;
 }
 
-static enum tcore_hook_return on_hook_network_registration_status(Server *s, CoreObject *source, enum tcore_notification_command command, unsigned int data_len, void *data, void *user_data)
+/* service type of the latest registration, reconciled or not */
+static int network_pending_svctype(void)
+{
+	struct network_pending *np;
+	GSList *l;
+	int svc_type = key_cache_lookup(VKEY_SVCTYPE) ? key_cache[VKEY_SVCTYPE].ival : 0;
+
+	for (l = network_pending_list; l; l = l->next) {
+		np = l->data;
+		if (np->have_status)
+			svc_type = np->status.service_type;
+	}
+
+	return svc_type;
+}
+
+static void network_reconcile(struct network_pending *np)
 {
-	const struct tnoti_network_registration_status *info = data;
-	int current;
 	int status;
 
-	dbg("vconf set");
+	if (np->have_change)
+		vconf_write_int(VKEY_PLMN, atoi(np->change.plmn));
 
-	/* CS */
-	if (info->cs_domain_status == NETWORK_SERVICE_DOMAIN_STATUS_FULL)
-		status = 2;
-	else
-		status = 1;
+	if (np->have_lac)
+		vconf_write_int(VKEY_LAC, np->lac);
 
-	vconf_get_int(VCONFKEY_TELEPHONY_SVC_CS, &current);
-	if (current != status)
-		vconf_set_int(VCONFKEY_TELEPHONY_SVC_CS, status);
+	if (np->have_cellid)
+		vconf_write_int(VKEY_CELLID, np->cell_id);
 
-	/* PS */
-	if (info->ps_domain_status == NETWORK_SERVICE_DOMAIN_STATUS_FULL)
-		status = 2;
-	else
-		status = 1;
+	if (np->have_status) {
+		/* CS */
+		if (np->status.cs_domain_status == NETWORK_SERVICE_DOMAIN_STATUS_FULL)
+			status = 2;
+		else
+			status = 1;
 
-	vconf_get_int(VCONFKEY_TELEPHONY_SVC_PS, &current);
-	if (current != status)
-		vconf_set_int(VCONFKEY_TELEPHONY_SVC_PS, status);
+		vconf_write_int(VKEY_SVC_CS, status);
 
-	/* Service type */
-	vconf_get_int(VCONFKEY_TELEPHONY_SVCTYPE, &current);
-	if (current != (int) info->service_type)
-		vconf_set_int(VCONFKEY_TELEPHONY_SVCTYPE, info->service_type);
+		/* PS */
+		if (np->status.ps_domain_status == NETWORK_SERVICE_DOMAIN_STATUS_FULL)
+			status = 2;
+		else
+			status = 1;
 
-	switch(info->service_type) {
-		case NETWORK_SERVICE_TYPE_UNKNOWN:
-		case NETWORK_SERVICE_TYPE_NO_SERVICE:
-			vconf_set_str(VCONFKEY_TELEPHONY_NWNAME, "No Service");
-			break;
+		vconf_write_int(VKEY_SVC_PS, status);
 
-		case NETWORK_SERVICE_TYPE_EMERGENCY:
-			vconf_set_str(VCONFKEY_TELEPHONY_NWNAME, "EMERGENCY");
-			break;
+		/* Service type */
+		vconf_write_int(VKEY_SVCTYPE, np->status.service_type);
 
-		case NETWORK_SERVICE_TYPE_SEARCH:
-			vconf_set_str(VCONFKEY_TELEPHONY_NWNAME, "Searching...");
-			break;
-		default:
-			break;
+		switch(np->status.service_type) {
+			case NETWORK_SERVICE_TYPE_UNKNOWN:
+			case NETWORK_SERVICE_TYPE_NO_SERVICE:
+				vconf_write_str(VKEY_NWNAME, "No Service");
+				break;
+
+			case NETWORK_SERVICE_TYPE_EMERGENCY:
+				vconf_write_str(VKEY_NWNAME, "EMERGENCY");
+				break;
+
+			case NETWORK_SERVICE_TYPE_SEARCH:
+				vconf_write_str(VKEY_NWNAME, "Searching...");
+				break;
+			default:
+				break;
+		}
+
+		vconf_write_int(VKEY_SVC_ROAM, np->status.roaming_status);
+	}
+
+	if (np->have_change || np->have_status)
+		_update_vconf_network_name(np->co, np->have_change ? np->change.plmn : NULL);
+}
+
+static gboolean __network_reconcile(gpointer user_data)
+{
+	gint64 start = metrics_begin();
+	GSList *list = network_pending_list;
+	struct network_pending *np;
+	guint32 cause = 0;
+	GSList *l;
+
+	network_reconcile_source = 0;
+	network_pending_list = NULL;
+
+	vconf_trace_begin(VCONF_TRACE_RECONCILE, "network_reconcile", 0, 0, 0);
+	for (l = list; l; l = l->next) {
+		np = l->data;
+		if (!network_pending_alive(np)) {
+			dbg("modem removed, pending network state dropped");
+			np->co = NULL;
+			continue;
+		}
+
+		vconf_trace_link(np->change_flow);
+		vconf_trace_link(np->status_flow);
+		vconf_trace_link(np->cellinfo_flow);
+		cause = MAX(cause, MAX(np->change_flow, MAX(np->status_flow, np->cellinfo_flow)));
 	}
+	vconf_trace_set_cause(cause);
 
-	vconf_set_int(VCONFKEY_TELEPHONY_SVC_ROAM, info->roaming_status);
+	stage.active = TRUE;
+	for (l = list; l; l = l->next) {
+		np = l->data;
+		if (np->co)
+			network_reconcile(np);
+	}
+	stage_commit();
+
+	vconf_trace_end(VCONF_TRACE_RECONCILE, "network_reconcile", 0, 0, 0);
+	vconf_trace_set_cause(0);
+
+	g_slist_free_full(list, g_free);
+
+	metrics_end(&metric_hist[METRIC_NETWORK_RECONCILE], start);
+	return FALSE;
+}
+
+static enum tcore_hook_return on_hook_network_location_cellinfo(Server *s, CoreObject *source, enum tcore_notification_command command, unsigned int data_len, void *data, void *user_data)
+{
+	const struct tnoti_network_location_cellinfo *info = data;
+	struct network_pending *np = network_pending_get(s, source);
+
+	vconf_radio_record(VCONF_RADIO_CELLID, info->cell_id);
+	vconf_radio_record(VCONF_RADIO_LAC, info->lac);
 
-	_update_vconf_network_name(source, NULL);
+	np->have_cellid = TRUE;
+	np->cell_id = info->cell_id;
+	np->have_lac = TRUE;
+	np->lac = info->lac;
+	np->cellinfo_flow = vconf_trace_cause();
 
 	return TCORE_HOOK_RETURN_CONTINUE;
 }
 
-static enum tcore_hook_return on_hook_network_change(Server *s, CoreObject *source, enum tcore_notification_command command, unsigned int data_len, void *data, void *user_data)
+static enum tcore_hook_return on_hook_network_icon_info(Server *s, CoreObject *source, enum tcore_notification_command command, unsigned int data_len, void *data, void *user_data)
 {
-	const struct tnoti_network_change *info = data;
+	const struct tnoti_network_icon_info *info = data;
 
-	dbg("vconf set");
+	vconf_radio_record(VCONF_RADIO_RSSI, info->rssi);
+	vconf_write_int(VKEY_RSSI, info->rssi);
+
+	return TCORE_HOOK_RETURN_CONTINUE;
+}
+
+static enum tcore_hook_return on_hook_network_registration_status(Server *s, CoreObject *source, enum tcore_notification_command command, unsigned int data_len, void *data, void *user_data)
+{
+	const struct tnoti_network_registration_status *info = data;
+	struct network_pending *np = network_pending_get(s, source);
+
+	vconf_radio_record(VCONF_RADIO_SVCTYPE, info->service_type);
+
+	np->have_status = TRUE;
+	np->status = *info;
+	np->status_flow = vconf_trace_cause();
 
-	vconf_set_int(VCONFKEY_TELEPHONY_PLMN, atoi(info->plmn));
-	vconf_set_int(VCONFKEY_TELEPHONY_LAC, info->gsm.lac);
+	return TCORE_HOOK_RETURN_CONTINUE;
+}
+
+static enum tcore_hook_return on_hook_network_change(Server *s, CoreObject *source, enum tcore_notification_command command, unsigned int data_len, void *data, void *user_data)
+{
+	const struct tnoti_network_change *info = data;
+	struct network_pending *np = network_pending_get(s, source);
 
-	_update_vconf_network_name(source, info->plmn);
+	np->have_change = TRUE;
+	np->change = *info;
+	np->have_lac = TRUE;
+	np->lac = info->gsm.lac;
+	np->change_flow = vconf_trace_cause();
 
 	return TCORE_HOOK_RETURN_CONTINUE;
 }
@@ -698,23 +2696,23 @@ static enum tcore_hook_return on_hook_sim_init(Server *s, CoreObject *source, en
 	const struct tnoti_sim_status *sim  = data;
 	dbg("vconf set");
 
-	vconf_set_int(VCONFKEY_TELEPHONY_SIM_CHV, sim->sim_status);
+	vconf_write_int(VKEY_SIM_CHV, sim->sim_status);
 
 	switch (sim->sim_status) {
 		case SIM_STATUS_CARD_ERROR:
-			vconf_set_int(VCONFKEY_TELEPHONY_SIM_SLOT, VCONFKEY_TELEPHONY_SIM_CARD_ERROR);
-			vconf_set_str(VCONFKEY_TELEPHONY_NWNAME, "SIM Error");
+			vconf_write_int(VKEY_SIM_SLOT, VCONFKEY_TELEPHONY_SIM_CARD_ERROR);
+			vconf_write_str(VKEY_NWNAME, "SIM Error");
 			break;
 
 		case SIM_STATUS_CARD_NOT_PRESENT:
 		case SIM_STATUS_CARD_REMOVED:
-			vconf_set_int(VCONFKEY_TELEPHONY_SIM_SLOT, VCONFKEY_TELEPHONY_SIM_NOT_PRESENT);
-			vconf_set_str(VCONFKEY_TELEPHONY_NWNAME, "NO SIM");
+			vconf_write_int(VKEY_SIM_SLOT, VCONFKEY_TELEPHONY_SIM_NOT_PRESENT);
+			vconf_write_str(VKEY_NWNAME, "NO SIM");
 			break;
 
 		case SIM_STATUS_INIT_COMPLETED:
-			vconf_set_int(VCONFKEY_TELEPHONY_SIM_SLOT, VCONFKEY_TELEPHONY_SIM_INSERTED);
-			vconf_set_int(VCONFKEY_TELEPHONY_SIM_INIT, VCONFKEY_TELEPHONY_SIM_INIT_COMPLETED);
+			vconf_write_int(VKEY_SIM_SLOT, VCONFKEY_TELEPHONY_SIM_INSERTED);
+			vconf_write_int(VKEY_SIM_INIT, VCONFKEY_TELEPHONY_SIM_INIT_COMPLETED);
 			break;
 
 		case SIM_STATUS_INITIALIZING:
@@ -726,7 +2724,7 @@ static enum tcore_hook_return on_hook_sim_init(Server *s, CoreObject *source, en
 		case SIM_STATUS_NSCK_REQUIRED:
 		case SIM_STATUS_SPCK_REQUIRED:
 		case SIM_STATUS_CCK_REQUIRED:
-			vconf_set_int(VCONFKEY_TELEPHONY_SIM_SLOT, VCONFKEY_TELEPHONY_SIM_INSERTED);
+			vconf_write_int(VKEY_SIM_SLOT, VCONFKEY_TELEPHONY_SIM_INSERTED);
 			break;
 
 		default:
@@ -741,7 +2739,7 @@ static enum tcore_hook_return on_hook_pb_init(Server *s, CoreObject *source, enu
 	const struct tnoti_phonebook_status *pb  = data;
 	dbg("vconf set");
 
-	if (vconf_set_int(VCONFKEY_TELEPHONY_SIM_PB_INIT, pb->b_init) != 0)
+	if (!vconf_write_int(VKEY_SIM_PB_INIT, pb->b_init))
 			dbg("[FAIL] UPDATE VCONFKEY_TELEPHONY_SIM_PB_INIT");
 
 	return TCORE_HOOK_RETURN_CONTINUE;
@@ -752,10 +2750,11 @@ static enum tcore_hook_return on_hook_ps_protocol_status(Server *s, CoreObject *
 {
 	enum telephony_network_service_type svc_type;
 	const struct tnoti_ps_protocol_status *noti = data;
+	int ps_type;
 
 	dbg("vconf set")
 
-	vconf_get_int(VCONFKEY_TELEPHONY_SVCTYPE, (int *)&svc_type);
+	svc_type = network_pending_svctype();
 	if(svc_type < (enum telephony_network_service_type)VCONFKEY_TELEPHONY_SVCTYPE_2G){
 		dbg("service state is not available");
 		return TCORE_HOOK_RETURN_CONTINUE;
@@ -763,22 +2762,28 @@ static enum tcore_hook_return on_hook_ps_protocol_status(Server *s, CoreObject *
 
 	switch (noti->status) {
 		case TELEPHONY_HSDPA_OFF:
-			vconf_set_int(VCONFKEY_TELEPHONY_PSTYPE, VCONFKEY_TELEPHONY_PSTYPE_NONE);
+			ps_type = VCONFKEY_TELEPHONY_PSTYPE_NONE;
 			break;
 
 		case TELEPHONY_HSDPA_ON:
-			vconf_set_int(VCONFKEY_TELEPHONY_PSTYPE, VCONFKEY_TELEPHONY_PSTYPE_HSDPA);
+			ps_type = VCONFKEY_TELEPHONY_PSTYPE_HSDPA;
 			break;
 
 		case TELEPHONY_HSUPA_ON:
-			vconf_set_int(VCONFKEY_TELEPHONY_PSTYPE, VCONFKEY_TELEPHONY_PSTYPE_HSUPA);
+			ps_type = VCONFKEY_TELEPHONY_PSTYPE_HSUPA;
 			break;
 
 		case TELEPHONY_HSPA_ON:
-			vconf_set_int(VCONFKEY_TELEPHONY_PSTYPE, VCONFKEY_TELEPHONY_PSTYPE_HSPA);
+			ps_type = VCONFKEY_TELEPHONY_PSTYPE_HSPA;
 			break;
+
+		default:
+			return TCORE_HOOK_RETURN_CONTINUE;
 	}
 
+	vconf_radio_record(VCONF_RADIO_PSTYPE, ps_type);
+	vconf_write_int(VKEY_PSTYPE, ps_type);
+
 	return TCORE_HOOK_RETURN_CONTINUE;
 }
 
@@ -789,7 +2794,7 @@ static enum tcore_hook_return on_hook_modem_power(Server *s, CoreObject *source,
 
 	if (power->state == MODEM_STATE_ONLINE) {
 		dbg("tapi ready");
-		vconf_set_int(VCONFKEY_TELEPHONY_TAPI_STATE, VCONFKEY_TELEPHONY_TAPI_STATE_READY);
+		vconf_write_int(VKEY_TAPI_STATE, VCONFKEY_TELEPHONY_TAPI_STATE_READY);
 	} else if (power->state == MODEM_STATE_ERROR) {
 
 		dbg("cp crash : all network setting will be reset");
@@ -797,42 +2802,524 @@ static enum tcore_hook_return on_hook_modem_power(Server *s, CoreObject *source,
 
 	} else {
 		dbg("tapi none");
-		vconf_set_int(VCONFKEY_TELEPHONY_TAPI_STATE, VCONFKEY_TELEPHONY_TAPI_STATE_NONE);
+		vconf_write_int(VKEY_TAPI_STATE, VCONFKEY_TELEPHONY_TAPI_STATE_NONE);
 	}
 
 	return TCORE_HOOK_RETURN_CONTINUE;
 }
 
+/*
+ * Notification hooks registered at on_init. Every notification enters
+ * through on_hook(), which stages the handler's writes and commits them
+ * once it returns, and times it when metrics are enabled.
+ */
+struct vconf_hook {
+	enum tcore_notification_command command;
+	TcoreServerNotificationHook func;
+	const char *name;
+	struct vconf_histogram hist;
+};
+
+static struct vconf_hook vconf_hooks[] = {
+	{ TNOTI_NETWORK_LOCATION_CELLINFO, on_hook_network_location_cellinfo, "network_location_cellinfo" },
+	{ TNOTI_NETWORK_ICON_INFO, on_hook_network_icon_info, "network_icon_info" },
+	{ TNOTI_NETWORK_REGISTRATION_STATUS, on_hook_network_registration_status, "network_registration_status" },
+	{ TNOTI_NETWORK_CHANGE, on_hook_network_change, "network_change" },
+	{ TNOTI_SIM_STATUS, on_hook_sim_init, "sim_init" },
+	{ TNOTI_PHONEBOOK_STATUS, on_hook_pb_init, "pb_init" },
+	{ TNOTI_PS_PROTOCOL_STATUS, on_hook_ps_protocol_status, "ps_protocol_status" },
+	{ TNOTI_MODEM_POWER, on_hook_modem_power, "modem_power" },
+};
+
+static Storage *vconf_strg;
+
+static enum tcore_hook_return on_hook(Server *s, CoreObject *source, enum tcore_notification_command command, unsigned int data_len, void *data, void *user_data)
+{
+	struct vconf_hook *hook = user_data;
+	enum tcore_hook_return ret;
+	gint64 start = metrics_begin();
+	guint32 flow = vconf_trace_flow_new();
+
+	vconf_trace_set_cause(flow);
+	vconf_trace_begin(VCONF_TRACE_HOOK, hook->name, command, data_len, flow);
+
+	stage.active = TRUE;
+	ret = hook->func(s, source, command, data_len, data, vconf_strg);
+	stage_commit();
+
+	vconf_trace_end(VCONF_TRACE_HOOK, hook->name, command, data_len, flow);
+	vconf_trace_set_cause(0);
+
+	metrics_end(&hook->hist, start);
+	return ret;
+}
+
+guint vconf_storage_get_radio_history(gint64 from, gint64 to, struct vconf_radio_record *out, guint max)
+{
+	return vconf_radio_snapshot(from, to, out, max);
+}
+
+void vconf_storage_flush(void)
+{
+	vconf_writer_flush();
+}
+
+gchar *vconf_storage_dump_trace(void)
+{
+	return vconf_trace_export();
+}
+
+gchar *vconf_storage_dump_metrics(gboolean json)
+{
+	GString *out;
+	unsigned int i;
+	gboolean first = TRUE;
+
+	out = g_string_new(json ? "{\"hooks\":{" : "");
+
+	for (i = 0; i < G_N_ELEMENTS(vconf_hooks); i++) {
+		if (json && i)
+			g_string_append_c(out, ',');
+		vconf_histogram_dump(&vconf_hooks[i].hist, vconf_hooks[i].name, out, json);
+	}
+
+	g_string_append(out, json ? "},\"ops\":{" : "");
+	for (i = 0; i < METRIC_MAX; i++) {
+		if (json && i)
+			g_string_append_c(out, ',');
+		vconf_histogram_dump(&metric_hist[i], metric_names[i], out, json);
+	}
+
+	g_string_append(out, json ? "},\"keys\":{" : "");
+	for (i = 0; i < VKEY_MAX; i++) {
+		if (!key_writes[i] && !key_suppressed[i] && !key_notifications[i])
+			continue;
+
+		if (json)
+			g_string_append_printf(out, "%s\"%s\":{\"writes\":%u,\"suppressed\":%u,\"notifications\":%u}",
+					first ? "" : ",", vconf_keys[i].name,
+					key_writes[i], key_suppressed[i], key_notifications[i]);
+		else
+			g_string_append_printf(out, "%s writes=%u suppressed=%u notifications=%u\n",
+					vconf_keys[i].name, key_writes[i], key_suppressed[i], key_notifications[i]);
+		first = FALSE;
+	}
+
+	if (json)
+		g_string_append_printf(out, "},\"cache\":{\"hits\":%u,\"misses\":%u},\"watches\":%u,"
+				"\"dispatch\":{\"batched\":%u,\"collapsed\":%u},"
+				"\"network_name\":{\"hits\":%u,\"misses\":%u}}",
+				key_cache_hits, key_cache_misses, active_watches, batch_dispatches, collapsed_dispatches,
+				name_memo_hits, name_memo_misses);
+	else
+		g_string_append_printf(out, "cache hits=%u misses=%u\nwatches active=%u\n"
+				"dispatch batched=%u collapsed=%u\nnetwork_name hits=%u misses=%u\n",
+				key_cache_hits, key_cache_misses, active_watches, batch_dispatches, collapsed_dispatches,
+				name_memo_hits, name_memo_misses);
+
+	return g_string_free(out, FALSE);
+}
+
+/*
+ * 1: dump as text to the log, 2: dump as JSON to VCONF_METRICS_PATH,
+ * 3: export the event trace to VCONF_TRACE_PATH,
+ * 4: export the radio history to VCONF_RADIO_PATH
+ */
+static void __metrics_trigger_callback(keynode_t* node, void* data)
+{
+	gchar *dump;
+	gchar **lines;
+	int i;
+
+	switch (vconf_keynode_get_int(node)) {
+		case 1:
+			dump = vconf_storage_dump_metrics(FALSE);
+			lines = g_strsplit(dump, "\n", -1);
+			for (i = 0; lines[i]; i++) {
+				if (lines[i][0])
+					dbg("%s", lines[i]);
+			}
+			g_strfreev(lines);
+			g_free(dump);
+			break;
+
+		case 2:
+			dump = vconf_storage_dump_metrics(TRUE);
+			if (!g_file_set_contents(VCONF_METRICS_PATH, dump, -1, NULL))
+				err("failed to write %s", VCONF_METRICS_PATH);
+			g_free(dump);
+			break;
+
+		case 3:
+			dump = vconf_trace_export();
+			if (!g_file_set_contents(VCONF_TRACE_PATH, dump, -1, NULL))
+				err("failed to write %s", VCONF_TRACE_PATH);
+			g_free(dump);
+			break;
+
+		case 4:
+			dump = vconf_radio_export();
+			if (!g_file_set_contents(VCONF_RADIO_PATH, dump, -1, NULL))
+				err("failed to write %s", VCONF_RADIO_PATH);
+			g_free(dump);
+			break;
+
+		default:
+			break;
+	}
+}
+
+static gchar *boot_id(void)
+{
+	gchar *id = NULL;
+
+	if (!g_file_get_contents(VCONF_BOOT_ID, &id, NULL, NULL))
+		return NULL;
+
+	return g_strstrip(id);
+}
+
+/*
+ * Snapshot: magic, SHA-1 of the payload, then a "(sxa{sv})" GVariant of
+ * boot id, monotonic time and the values of the VCONF_SCHEMA_WARM keys.
+ * Keys restored but not yet confirmed by the modem are left out, so a
+ * crash loop cannot keep stale values alive.
+ */
+static void warm_state_save(void)
+{
+	const struct vconf_schema_entry *e;
+	GVariantBuilder builder;
+	enum vconf_key_id id;
+	GVariant *state;
+	GString *out;
+	gchar *boot, *sum;
+	unsigned int i;
+
+	if (warm_state_timer)
+		g_source_remove(warm_state_timer);
+	warm_state_timer = 0;
+
+	g_variant_builder_init(&builder, G_VARIANT_TYPE("a{sv}"));
+	for (i = 0; i < G_N_ELEMENTS(vconf_schema); i++) {
+		e = &vconf_schema[i];
+		if (!(e->flags & VCONF_SCHEMA_WARM))
+			continue;
+
+		id = convert_vconf_to_id(e->name);
+		if (id == VKEY_MAX || !key_cache[id].valid || warm_unconfirmed[id])
+			continue;
+
+		switch (e->type) {
+			case VCONF_TYPE_INT:
+				g_variant_builder_add(&builder, "{sv}", e->name, g_variant_new_int32(key_cache[id].ival));
+				break;
+
+			case VCONF_TYPE_BOOL:
+				g_variant_builder_add(&builder, "{sv}", e->name, g_variant_new_boolean(key_cache[id].ival));
+				break;
+
+			case VCONF_TYPE_STRING:
+				g_variant_builder_add(&builder, "{sv}", e->name, g_variant_new_string(key_cache[id].sval));
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	boot = boot_id();
+	state = g_variant_ref_sink(g_variant_new("(sxa{sv})", boot ? boot : "",
+				g_get_monotonic_time(), &builder));
+	sum = g_compute_checksum_for_data(G_CHECKSUM_SHA1,
+			g_variant_get_data(state), g_variant_get_size(state));
+
+	out = g_string_new(VCONF_WARM_STATE_MAGIC);
+	g_string_append(out, sum);
+	g_string_append_len(out, g_variant_get_data(state), g_variant_get_size(state));
+
+	if (!g_file_set_contents(VCONF_WARM_STATE_PATH, out->str, out->len, NULL))
+		err("failed to write %s", VCONF_WARM_STATE_PATH);
+
+	g_string_free(out, TRUE);
+	g_free(sum);
+	g_free(boot);
+	g_variant_unref(state);
+}
+
+static gboolean __warm_state_timeout(gpointer user_data)
+{
+	warm_state_timer = 0;
+	warm_state_save();
+
+	return FALSE;
+}
+
+/* the saved "a{sv}" if the snapshot is intact, from this boot and fresh */
+static GVariant *warm_state_load(void)
+{
+	GVariant *snapshot = NULL;
+	GVariant *state = NULL;
+	const gchar *saved_boot;
+	gchar *contents = NULL;
+	gchar *boot = NULL;
+	gpointer payload;
+	gchar *sum;
+	gint64 saved, now;
+	gsize len;
+
+	if (!g_file_get_contents(VCONF_WARM_STATE_PATH, &contents, &len, NULL))
+		return NULL;
+
+	if (len <= VCONF_WARM_STATE_HEADER || memcmp(contents, VCONF_WARM_STATE_MAGIC, 8) != 0)
+		goto out;
+
+	sum = g_compute_checksum_for_data(G_CHECKSUM_SHA1,
+			(const guchar *)contents + VCONF_WARM_STATE_HEADER, len - VCONF_WARM_STATE_HEADER);
+	if (memcmp(sum, contents + 8, 40) != 0) {
+		g_free(sum);
+		goto out;
+	}
+	g_free(sum);
+
+	/* own, aligned copy of the payload */
+	payload = g_malloc(len - VCONF_WARM_STATE_HEADER);
+	memcpy(payload, contents + VCONF_WARM_STATE_HEADER, len - VCONF_WARM_STATE_HEADER);
+	snapshot = g_variant_ref_sink(g_variant_new_from_data(G_VARIANT_TYPE("(sxa{sv})"),
+				payload, len - VCONF_WARM_STATE_HEADER, FALSE, g_free, NULL));
+	if (!g_variant_is_normal_form(snapshot))
+		goto out;
+
+	g_variant_get(snapshot, "(&sx@a{sv})", &saved_boot, &saved, &state);
+
+	boot = boot_id();
+	now = g_get_monotonic_time();
+	if (!boot || g_strcmp0(boot, saved_boot) != 0 || saved > now
+			|| now - saved > (gint64)warm_restart_max_age * G_USEC_PER_SEC) {
+		dbg("warm restart: snapshot is stale");
+		g_variant_unref(state);
+		state = NULL;
+	}
+
+out:
+	if (snapshot)
+		g_variant_unref(snapshot);
+	g_free(boot);
+	g_free(contents);
+
+	return state;
+}
+
+/* restored keys the modem has not re-reported by now go back to default */
+static gboolean __warm_reconcile_timeout(gpointer user_data)
+{
+	const struct vconf_schema_entry *e;
+	struct vconf_batch b;
+	enum vconf_key_id id;
+	unsigned int i;
+	int count;
+
+	warm_reconcile_timer = 0;
+
+	vconf_batch_begin(&b);
+	for (i = 0; i < G_N_ELEMENTS(vconf_schema); i++) {
+		e = &vconf_schema[i];
+		id = convert_vconf_to_id(e->name);
+		if (id == VKEY_MAX || !warm_unconfirmed[id])
+			continue;
+
+		warm_unconfirmed[id] = FALSE;
+		switch (e->type) {
+			case VCONF_TYPE_INT:
+				vconf_batch_int(&b, id, e->ival);
+				break;
+
+			case VCONF_TYPE_BOOL:
+				vconf_batch_bool(&b, id, e->ival);
+				break;
+
+			case VCONF_TYPE_STRING:
+				vconf_batch_str(&b, id, e->sval);
+				break;
+
+			default:
+				break;
+		}
+	}
+	count = vconf_batch_commit(&b);
+
+	dbg("warm restart: %d unconfirmed keys reset", count);
+	warm_state_schedule();
+
+	return FALSE;
+}
+
+static void warm_state_cancel(void)
+{
+	if (warm_state_timer)
+		g_source_remove(warm_state_timer);
+	warm_state_timer = 0;
+
+	if (warm_reconcile_timer)
+		g_source_remove(warm_reconcile_timer);
+	warm_reconcile_timer = 0;
+
+	memset(warm_unconfirmed, 0, sizeof(warm_unconfirmed));
+}
+
+/*
+ * Writes the schema default of every reset key, or its value in state
+ * (a warm-restart snapshot) when present with the right type.
+ */
+static void reset_vconf_keys(GVariant *state)
+{
+	const struct vconf_schema_entry *e;
+	struct vconf_batch b;
+	enum vconf_key_id id;
+	GVariant *value;
+	unsigned int i;
+	gint64 start;
+	int restored = 0;
+	int count;
+
+	start = g_get_monotonic_time();
+
+	if (warm_reconcile_timer)
+		g_source_remove(warm_reconcile_timer);
+	warm_reconcile_timer = 0;
+	memset(warm_unconfirmed, 0, sizeof(warm_unconfirmed));
+
+	stage_clear();
+	network_pending_clear();
+	key_policy_cancel_all();
+	low_lane_cancel_all();
+	network_name_memo_clear();
+
+	vconf_batch_begin(&b);
+	for (i = 0; i < G_N_ELEMENTS(vconf_schema); i++) {
+		e = &vconf_schema[i];
+		if (!(e->flags & VCONF_SCHEMA_RESET))
+			continue;
+
+		id = convert_vconf_to_id(e->name);
+		if (id == VKEY_MAX)
+			continue;
+
+		value = NULL;
+		if (state && (e->flags & VCONF_SCHEMA_WARM))
+			value = g_variant_lookup_value(state, e->name, NULL);
+
+		switch (e->type) {
+			case VCONF_TYPE_INT:
+				if (value && g_variant_is_of_type(value, G_VARIANT_TYPE_INT32)) {
+					vconf_batch_int(&b, id, g_variant_get_int32(value));
+					warm_unconfirmed[id] = TRUE;
+				}
+				else
+					vconf_batch_int(&b, id, e->ival);
+				break;
+
+			case VCONF_TYPE_BOOL:
+				if (value && g_variant_is_of_type(value, G_VARIANT_TYPE_BOOLEAN)) {
+					vconf_batch_bool(&b, id, g_variant_get_boolean(value));
+					warm_unconfirmed[id] = TRUE;
+				}
+				else
+					vconf_batch_bool(&b, id, e->ival);
+				break;
+
+			case VCONF_TYPE_STRING:
+				if (value && g_variant_is_of_type(value, G_VARIANT_TYPE_STRING)) {
+					vconf_batch_str(&b, id, g_variant_get_string(value, NULL));
+					warm_unconfirmed[id] = TRUE;
+				}
+				else
+					vconf_batch_str(&b, id, e->sval);
+				break;
+
+			default:
+				break;
+		}
+
+		if (warm_unconfirmed[id])
+			restored++;
+		if (value)
+			g_variant_unref(value);
+	}
+	count = vconf_batch_commit(&b);
+
+	dbg("reset: %d keys written (%d restored) in %lld us", count, restored,
+			(long long)(g_get_monotonic_time() - start));
+
+	if (restored)
+		warm_reconcile_timer = g_timeout_add_seconds(warm_restart_grace, __warm_reconcile_timeout, NULL);
+
+	warm_state_schedule();
+}
+
 static void reset_vconf()
 {
-	vconf_set_str(VCONFKEY_TELEPHONY_NWNAME, "");
-	vconf_set_int(VCONFKEY_TELEPHONY_PLMN, 0);
-	vconf_set_int(VCONFKEY_TELEPHONY_LAC, 0);
-	vconf_set_int(VCONFKEY_TELEPHONY_CELLID, 0);
-	vconf_set_int(VCONFKEY_TELEPHONY_SVCTYPE, VCONFKEY_TELEPHONY_SVCTYPE_NONE);
-	vconf_set_int(VCONFKEY_TELEPHONY_SVC_CS, VCONFKEY_TELEPHONY_SVC_CS_UNKNOWN);
-	vconf_set_int(VCONFKEY_TELEPHONY_SVC_PS, VCONFKEY_TELEPHONY_SVC_PS_UNKNOWN);
-	vconf_set_int(VCONFKEY_TELEPHONY_SVC_ROAM, VCONFKEY_TELEPHONY_SVC_ROAM_OFF);
-	vconf_set_int(VCONFKEY_TELEPHONY_ZONE_TYPE, VCONFKEY_TELEPHONY_ZONE_NONE);
-	vconf_set_int(VCONFKEY_TELEPHONY_SIM_INIT, VCONFKEY_TELEPHONY_SIM_INIT_NONE);
-	vconf_set_int(VCONFKEY_TELEPHONY_SIM_CHV, 0xFF);
-	vconf_set_int(VCONFKEY_TELEPHONY_SIM_SLOT, VCONFKEY_TELEPHONY_SIM_UNKNOWN);
-	vconf_set_int(VCONFKEY_TELEPHONY_SIM_PB_INIT, VCONFKEY_TELEPHONY_SIM_PB_INIT_NONE);
-	vconf_set_int(VCONFKEY_TELEPHONY_CALL_STATE, VCONFKEY_TELEPHONY_CALL_CONNECT_IDLE);
-	vconf_set_int(VCONFKEY_TELEPHONY_CALL_FORWARD_STATE, VCONFKEY_TELEPHONY_CALL_FORWARD_OFF);
-	vconf_set_int(VCONFKEY_TELEPHONY_TAPI_STATE, VCONFKEY_TELEPHONY_TAPI_STATE_NONE);
-	vconf_set_int(VCONFKEY_TELEPHONY_SPN_DISP_CONDITION, VCONFKEY_TELEPHONY_DISP_INVALID);
-	vconf_set_str(VCONFKEY_TELEPHONY_SPN_NAME, "");
-	vconf_set_int(VCONFKEY_TELEPHONY_SAT_STATE, VCONFKEY_TELEPHONY_SAT_NONE);
-	vconf_set_str(VCONFKEY_TELEPHONY_SAT_SETUP_IDLE_TEXT, "");
-	vconf_set_int(VCONFKEY_TELEPHONY_ZONE_ZUHAUSE, 0);
-	vconf_set_int(VCONFKEY_TELEPHONY_RSSI, VCONFKEY_TELEPHONY_RSSI_0);
-	vconf_set_int(VCONFKEY_TELEPHONY_LOW_BATTERY, VCONFKEY_TELEPHONY_BATT_NORMAL_LEVEL);
-	vconf_set_str(VCONFKEY_TELEPHONY_IMEI, "deprecated_vconf_imei");
-	vconf_set_str(VCONFKEY_TELEPHONY_SUBSCRIBER_NUMBER, "");
-	vconf_set_str(VCONFKEY_TELEPHONY_SUBSCRIBER_NAME, "");
-	vconf_set_int(VCONFKEY_TELEPHONY_SIM_PB_INIT,VCONFKEY_TELEPHONY_SIM_PB_INIT_NONE);
-	vconf_set_bool(VCONFKEY_TELEPHONY_READY, 0);
+	reset_vconf_keys(NULL);
+}
+
+/*
+ * Optional plugin configuration (GKeyFile). [general] holds plugin-wide
+ * switches and a group named after a vconf int key sets its write
+ * policy, e.g.
+ *
+ * [general]
+ * metrics=true
+ * shm=true
+ * write_behind=true
+ * write_queue=256
+ * pkt_flush_interval=60
+ * radio_history=1024
+ * operator_index=/usr/share/tel-plugin-vconf/operators.idx
+ * warm_restart=true
+ * warm_restart_max_age=60
+ * warm_restart_grace=30
+ * dispatch_window=0
+ * trace=0
+ *
+ * [memory/telephony/rssi]
+ * min_interval=2000
+ * hysteresis=1
+ * flush_delay=2000
+ */
+static void config_load(void)
+{
+	GKeyFile *kf;
+
+	kf = g_key_file_new();
+	if (!g_key_file_load_from_file(kf, VCONF_PLUGIN_CONF, G_KEY_FILE_NONE, NULL)) {
+		dbg("no configuration (%s)", VCONF_PLUGIN_CONF);
+		g_key_file_free(kf);
+		return;
+	}
+
+	metrics_enabled = g_key_file_get_boolean(kf, "general", "metrics", NULL);
+	if (g_key_file_has_key(kf, "general", "shm", NULL))
+		shm_enabled = g_key_file_get_boolean(kf, "general", "shm", NULL);
+	write_behind = g_key_file_get_boolean(kf, "general", "write_behind", NULL);
+	if (g_key_file_has_key(kf, "general", "write_queue", NULL))
+		write_queue_max = MAX(g_key_file_get_integer(kf, "general", "write_queue", NULL), 1);
+	dispatch_window = MAX(g_key_file_get_integer(kf, "general", "dispatch_window", NULL), 0);
+	trace_events = MAX(g_key_file_get_integer(kf, "general", "trace", NULL), 0);
+	warm_restart = g_key_file_get_boolean(kf, "general", "warm_restart", NULL);
+	if (g_key_file_has_key(kf, "general", "warm_restart_max_age", NULL))
+		warm_restart_max_age = MAX(g_key_file_get_integer(kf, "general", "warm_restart_max_age", NULL), 0);
+	if (g_key_file_has_key(kf, "general", "warm_restart_grace", NULL))
+		warm_restart_grace = MAX(g_key_file_get_integer(kf, "general", "warm_restart_grace", NULL), 1);
+	if (g_key_file_has_key(kf, "general", "operator_index", NULL)) {
+		g_free(operator_index);
+		operator_index = g_key_file_get_string(kf, "general", "operator_index", NULL);
+	}
+	if (g_key_file_has_key(kf, "general", "radio_history", NULL))
+		radio_history = MAX(g_key_file_get_integer(kf, "general", "radio_history", NULL), 0);
+	if (g_key_file_has_key(kf, "general", "pkt_flush_interval", NULL))
+		pkt_flush_interval = MAX(g_key_file_get_integer(kf, "general", "pkt_flush_interval", NULL), 1);
+	key_policy_load(kf);
+
+	g_key_file_free(kf);
 }
 
 static gboolean on_load()
@@ -845,29 +3332,60 @@ static gboolean on_load()
 static gboolean on_init(TcorePlugin *p)
 {
 	Storage *strg;
+	GVariant *state = NULL;
 	Server *s;
+	unsigned int i;
 
 	if (!p)
 		return FALSE;
 
 	dbg("i'm init!");
 
+	vconf_key_index_init();
+
 	strg = tcore_storage_new(p, "vconf", &ops);
 
-	reset_vconf();
+	config_load();
+	key_cache_init();
+	vconf_radio_init(radio_history);
+	vconf_trace_init(trace_events);
+
+	if (!vconf_operator_index_open(operator_index ? operator_index : VCONF_OPERATOR_INDEX_PATH)) {
+		dbg("no valid operator index (%s), using %s", operator_index ? operator_index : VCONF_OPERATOR_INDEX_PATH,
+				VCONF_OPERATOR_DB_PATH);
+		if (!operator_index_load_db(tcore_plugin_ref_server(p)))
+			err("no operator names, NWNAME falls back to the PLMN");
+	}
+
+	if (write_behind)
+		vconf_writer_start(write_queue_max, backend_failed);
+
+	if (shm_enabled)
+		tcore_storage_new(p, "vconf-shm", &shm_ops);
+
+	if (warm_restart)
+		state = warm_state_load();
+
+	if (state) {
+		dbg("warm restart");
+		reset_vconf_keys(state);
+		g_variant_unref(state);
+	}
+	else {
+		reset_vconf();
+	}
+	pkt_counters_load();
 
-	vconf_set_int(VCONFKEY_TELEPHONY_LOW_BATTERY, VCONFKEY_TELEPHONY_BATT_NORMAL_LEVEL);
-	vconf_set_int(VCONFKEY_TELEPHONY_SVC_ROAM, VCONFKEY_TELEPHONY_SVC_ROAM_OFF);
+	vconf_write_int(VKEY_LOW_BATTERY, VCONFKEY_TELEPHONY_BATT_NORMAL_LEVEL);
+	vconf_write_int(VKEY_SVC_ROAM, VCONFKEY_TELEPHONY_SVC_ROAM_OFF);
 
+	vconf_notify_key_changed(VCONF_METRICS_TRIGGER, __metrics_trigger_callback, NULL);
+	vconf_notify_key_changed(VCONFKEY_PM_STATE, __pm_state_callback, NULL);
+
+	vconf_strg = strg;
 	s = tcore_plugin_ref_server(p);
-	tcore_server_add_notification_hook(s, TNOTI_NETWORK_LOCATION_CELLINFO, on_hook_network_location_cellinfo, strg);
-	tcore_server_add_notification_hook(s, TNOTI_NETWORK_ICON_INFO, on_hook_network_icon_info, strg);
-	tcore_server_add_notification_hook(s, TNOTI_NETWORK_REGISTRATION_STATUS, on_hook_network_registration_status, strg);
-	tcore_server_add_notification_hook(s, TNOTI_NETWORK_CHANGE, on_hook_network_change, strg);
-	tcore_server_add_notification_hook(s, TNOTI_SIM_STATUS, on_hook_sim_init, strg);
-	tcore_server_add_notification_hook(s, TNOTI_PHONEBOOK_STATUS, on_hook_pb_init, strg);
-	tcore_server_add_notification_hook(s, TNOTI_PS_PROTOCOL_STATUS, on_hook_ps_protocol_status, strg);
-	tcore_server_add_notification_hook(s, TNOTI_MODEM_POWER, on_hook_modem_power, strg);
+	for (i = 0; i < G_N_ELEMENTS(vconf_hooks); i++)
+		tcore_server_add_notification_hook(s, vconf_hooks[i].command, on_hook, &vconf_hooks[i]);
 
 	return TRUE;
 }
@@ -881,6 +3399,33 @@ static void on_unload(TcorePlugin *p)
 
 	dbg("i'm unload");
 
+	vconf_ignore_key_changed(VCONF_METRICS_TRIGGER, __metrics_trigger_callback);
+	vconf_ignore_key_changed(VCONFKEY_PM_STATE, __pm_state_callback);
+	vconf_strg = NULL;
+
+	key_policy_cancel_all();
+	low_lane_cancel_all();
+	network_pending_clear();
+	pkt_counters_flush();
+	if (warm_restart)
+		warm_state_save();
+	warm_state_cancel();
+	vconf_writer_stop();
+	vconf_trace_free();
+	subscriber_free_all();
+	variant_free_all();
+	network_name_memo_free();
+	vconf_radio_free();
+	vconf_operator_index_close();
+	g_free(operator_index);
+	operator_index = NULL;
+	key_cache_free();
+	vconf_key_index_free();
+
+	strg = tcore_server_find_storage(tcore_plugin_ref_server(p), "vconf-shm");
+	if (strg)
+		tcore_storage_free(strg);
+
 	strg = tcore_server_find_storage(tcore_plugin_ref_server(p), "vconf");
 	if (!strg)
 		return;
@@ -888,6 +3433,29 @@ static void on_unload(TcorePlugin *p)
 	tcore_storage_free(strg);
 }
 
+const struct vconf_storage_api vconf_storage_api = {
+	.version = VCONF_STORAGE_API_VERSION,
+
+	.add_key_callback = vconf_storage_add_key_callback,
+	.remove_key_callback = vconf_storage_remove_key_callback,
+	.add_key_callbacks = vconf_storage_add_key_callbacks,
+	.remove_key_callbacks = vconf_storage_remove_key_callbacks,
+	.active_watches = vconf_storage_active_watches,
+
+	.add_batch_callback = vconf_storage_add_batch_callback,
+	.remove_batch_callback = vconf_storage_remove_batch_callback,
+	.collapsed_dispatches = vconf_storage_collapsed_dispatches,
+
+	.get_multi = vconf_storage_get_multi,
+	.get_int64 = vconf_storage_get_int64,
+	.set_int64 = vconf_storage_set_int64,
+
+	.get_radio_history = vconf_storage_get_radio_history,
+	.flush = vconf_storage_flush,
+	.dump_metrics = vconf_storage_dump_metrics,
+	.dump_trace = vconf_storage_dump_trace,
+};
+
 struct tcore_plugin_define_desc plugin_define_desc =
 {
 	.name = "VCONF_STORAGE",
@@ -0,0 +1,78 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <glib.h>
+
+#include "vconf-metrics.h"
+
+void vconf_histogram_add(struct vconf_histogram *h, gint64 us)
+{
+	guint b = 0;
+	guint64 v;
+
+	if (us < 0)
+		us = 0;
+
+	for (v = (guint64)us; v && b < VCONF_HISTOGRAM_BUCKETS - 1; v >>= 1)
+		b++;
+
+	h->buckets[b]++;
+	h->count++;
+	h->total_us += us;
+	if (us > h->max_us)
+		h->max_us = us;
+}
+
+/* upper bound (us) of the bucket holding the pct-th percentile */
+guint vconf_histogram_percentile(const struct vconf_histogram *h, guint pct)
+{
+	guint64 target;
+	guint64 seen = 0;
+	guint b;
+
+	if (!h->count)
+		return 0;
+
+	target = ((guint64)h->count * pct + 99) / 100;
+	for (b = 0; b < VCONF_HISTOGRAM_BUCKETS; b++) {
+		seen += h->buckets[b];
+		if (seen >= target)
+			return MIN(1u << b, h->max_us);
+	}
+
+	return h->max_us;
+}
+
+void vconf_histogram_dump(const struct vconf_histogram *h, const char *name, GString *out, gboolean json)
+{
+	guint avg = h->count ? (guint)(h->total_us / h->count) : 0;
+
+	if (json) {
+		g_string_append_printf(out,
+				"\"%s\":{\"count\":%u,\"avg_us\":%u,\"p50_us\":%u,\"p99_us\":%u,\"max_us\":%u}",
+				name, h->count, avg, vconf_histogram_percentile(h, 50),
+				vconf_histogram_percentile(h, 99), h->max_us);
+		return;
+	}
+
+	g_string_append_printf(out, "%s count=%u avg=%uus p50=%uus p99=%uus max=%uus\n",
+			name, h->count, avg, vconf_histogram_percentile(h, 50),
+			vconf_histogram_percentile(h, 99), h->max_us);
+}
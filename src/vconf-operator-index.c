@@ -0,0 +1,101 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * tel-vconf-operator-index: build the operator name index
+ *
+ * usage: tel-vconf-operator-index <input> [output]
+ *
+ * Each input line is "mcc<TAB>mnc<TAB>country<TAB>name"; empty lines and
+ * lines starting with '#' are skipped. For a repeated MCC/MNC the first
+ * line wins. The output defaults to VCONF_OPERATOR_INDEX_PATH.
+ */
+
+#include <stdio.h>
+
+#include <glib.h>
+
+#include "vconf-operator.h"
+
+int main(int argc, char *argv[])
+{
+	struct vconf_operator_row row;
+	const char *out_path = argc > 2 ? argv[2] : VCONF_OPERATOR_INDEX_PATH;
+	GArray *rows;
+	GPtrArray *fields;
+	gchar *contents, *out;
+	gchar **lines, **f;
+	GError *error = NULL;
+	gsize size;
+	guint i;
+
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s <input> [output]\n", argv[0]);
+		return 1;
+	}
+
+	if (!g_file_get_contents(argv[1], &contents, NULL, &error)) {
+		fprintf(stderr, "%s: %s\n", argv[1], error->message);
+		g_error_free(error);
+		return 1;
+	}
+
+	rows = g_array_new(FALSE, FALSE, sizeof(struct vconf_operator_row));
+	fields = g_ptr_array_new_with_free_func((GDestroyNotify)g_strfreev);
+
+	lines = g_strsplit(contents, "\n", -1);
+	for (i = 0; lines[i]; i++) {
+		g_strchomp(lines[i]);
+		if (!lines[i][0] || lines[i][0] == '#')
+			continue;
+
+		f = g_strsplit(lines[i], "\t", 4);
+		if (g_strv_length(f) != 4 || vconf_operator_key(f[0], f[1]) == VCONF_OPERATOR_KEY_INVALID) {
+			fprintf(stderr, "%s:%u: skipped\n", argv[1], i + 1);
+			g_strfreev(f);
+			continue;
+		}
+
+		row.mcc = f[0];
+		row.mnc = f[1];
+		row.country = f[2];
+		row.name = f[3];
+		g_array_append_val(rows, row);
+		g_ptr_array_add(fields, f);
+	}
+	g_strfreev(lines);
+	g_free(contents);
+
+	out = vconf_operator_index_build((const struct vconf_operator_row *)rows->data, rows->len, &size);
+
+	if (!g_file_set_contents(out_path, out, size, &error)) {
+		fprintf(stderr, "%s: %s\n", out_path, error->message);
+		g_error_free(error);
+		return 1;
+	}
+
+	printf("%s: %u operators\n", out_path, ((struct vconf_operator_index_header *)out)->count);
+
+	g_free(out);
+	g_ptr_array_free(fields, TRUE);
+	g_array_free(rows, TRUE);
+
+	return 0;
+}
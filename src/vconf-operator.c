@@ -0,0 +1,279 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <glib.h>
+
+#include "vconf-operator.h"
+
+static const struct vconf_operator_index_entry *index_entries;
+static const char *index_strings;
+static guint32 index_count;
+static void *index_addr;
+static gsize index_size;
+static gboolean index_mapped;		/* mmap()ed file, else g_malloc()ed */
+
+static guint32 digits(const char *s, int *len)
+{
+	guint32 v = 0;
+
+	for (*len = 0; s[*len]; (*len)++) {
+		if (!g_ascii_isdigit(s[*len]))
+			return VCONF_OPERATOR_KEY_INVALID;
+		v = v * 10 + (s[*len] - '0');
+	}
+
+	return v;
+}
+
+guint32 vconf_operator_key(const char *mcc, const char *mnc)
+{
+	guint32 mcc_v, mnc_v;
+	int mcc_len, mnc_len;
+
+	if (!mcc || !mnc)
+		return VCONF_OPERATOR_KEY_INVALID;
+
+	mcc_v = digits(mcc, &mcc_len);
+	mnc_v = digits(mnc, &mnc_len);
+	if (mcc_v == VCONF_OPERATOR_KEY_INVALID || mnc_v == VCONF_OPERATOR_KEY_INVALID
+			|| mcc_len != 3 || mnc_len < 2 || mnc_len > 3)
+		return VCONF_OPERATOR_KEY_INVALID;
+
+	return (mcc_v << 12) | (mnc_len == 3 ? 0x800 : 0) | mnc_v;
+}
+
+static guint32 pool_add(GString *pool, GHashTable *pool_index, const char *s)
+{
+	gpointer off;
+
+	if (g_hash_table_lookup_extended(pool_index, s, NULL, &off))
+		return GPOINTER_TO_UINT(off);
+
+	off = GUINT_TO_POINTER(pool->len);
+	g_string_append_len(pool, s, strlen(s) + 1);
+	g_hash_table_insert(pool_index, (gpointer)s, off);
+
+	return GPOINTER_TO_UINT(off);
+}
+
+static gint entry_cmp(gconstpointer a, gconstpointer b)
+{
+	const struct vconf_operator_index_entry *ea = a, *eb = b;
+
+	/* g_array_sort() is stable, so the first row of a key stays first */
+	if (ea->key != eb->key)
+		return ea->key < eb->key ? -1 : 1;
+
+	return 0;
+}
+
+gchar *vconf_operator_index_build(const struct vconf_operator_row *rows, guint count, gsize *size)
+{
+	struct vconf_operator_index_header h;
+	struct vconf_operator_index_entry e, *prev;
+	GArray *entries, *unique;
+	GHashTable *pool_index;
+	GString *pool, *out;
+	guint i;
+
+	pool = g_string_new(NULL);
+	pool_index = g_hash_table_new(g_str_hash, g_str_equal);
+	entries = g_array_sized_new(FALSE, FALSE, sizeof(struct vconf_operator_index_entry), count);
+
+	for (i = 0; i < count; i++) {
+		e.key = vconf_operator_key(rows[i].mcc, rows[i].mnc);
+		if (e.key == VCONF_OPERATOR_KEY_INVALID || !rows[i].name)
+			continue;
+
+		e.country = pool_add(pool, pool_index, rows[i].country ? rows[i].country : "");
+		e.name = pool_add(pool, pool_index, rows[i].name);
+		g_array_append_val(entries, e);
+	}
+
+	g_array_sort(entries, entry_cmp);
+
+	unique = g_array_sized_new(FALSE, FALSE, sizeof(struct vconf_operator_index_entry), entries->len);
+	for (i = 0; i < entries->len; i++) {
+		prev = unique->len ? &g_array_index(unique, struct vconf_operator_index_entry, unique->len - 1) : NULL;
+		if (prev && prev->key == g_array_index(entries, struct vconf_operator_index_entry, i).key)
+			continue;
+		g_array_append_val(unique, g_array_index(entries, struct vconf_operator_index_entry, i));
+	}
+
+	if (!pool->len)
+		g_string_append_c(pool, '\0');
+
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, VCONF_OPERATOR_INDEX_MAGIC, sizeof(h.magic));
+	h.version = VCONF_OPERATOR_INDEX_VERSION;
+	h.count = unique->len;
+	h.strings_size = pool->len;
+
+	out = g_string_new_len((const gchar *)&h, sizeof(h));
+	g_string_append_len(out, unique->data, unique->len * sizeof(struct vconf_operator_index_entry));
+	g_string_append_len(out, pool->str, pool->len);
+
+	g_array_free(unique, TRUE);
+	g_array_free(entries, TRUE);
+	g_hash_table_destroy(pool_index);
+	g_string_free(pool, TRUE);
+
+	*size = out->len;
+	return g_string_free(out, FALSE);
+}
+
+static gboolean index_validate(const void *addr, gsize size)
+{
+	const struct vconf_operator_index_header *h = addr;
+	const struct vconf_operator_index_entry *e;
+	const char *strings;
+	guint32 i;
+
+	if (size < sizeof(*h) || memcmp(h->magic, VCONF_OPERATOR_INDEX_MAGIC, sizeof(h->magic)) != 0
+			|| h->version != VCONF_OPERATOR_INDEX_VERSION)
+		return FALSE;
+
+	if (!h->strings_size || h->count > (size - sizeof(*h)) / sizeof(*e)
+			|| size != sizeof(*h) + (gsize)h->count * sizeof(*e) + h->strings_size)
+		return FALSE;
+
+	e = (const struct vconf_operator_index_entry *)(h + 1);
+	strings = (const char *)(e + h->count);
+
+	/* every offset then ends inside the pool */
+	if (strings[h->strings_size - 1] != '\0')
+		return FALSE;
+
+	for (i = 0; i < h->count; i++) {
+		if (e[i].name >= h->strings_size || e[i].country >= h->strings_size)
+			return FALSE;
+		if (i && e[i].key <= e[i - 1].key)
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void index_set(void *addr, gsize size, gboolean mapped)
+{
+	index_addr = addr;
+	index_size = size;
+	index_mapped = mapped;
+	index_count = ((const struct vconf_operator_index_header *)addr)->count;
+	index_entries = (const struct vconf_operator_index_entry *)
+		((const struct vconf_operator_index_header *)addr + 1);
+	index_strings = (const char *)(index_entries + index_count);
+}
+
+gboolean vconf_operator_index_open(const char *path)
+{
+	struct stat st;
+	void *addr;
+	int fd;
+
+	vconf_operator_index_close();
+
+	fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return FALSE;
+
+	if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+		close(fd);
+		return FALSE;
+	}
+
+	addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED)
+		return FALSE;
+
+	if (!index_validate(addr, st.st_size)) {
+		munmap(addr, st.st_size);
+		return FALSE;
+	}
+
+	index_set(addr, st.st_size, TRUE);
+
+	return TRUE;
+}
+
+gboolean vconf_operator_index_load(gchar *data, gsize size)
+{
+	vconf_operator_index_close();
+
+	/* g_malloc() memory is aligned for the entries */
+	if (!data || !index_validate(data, size))
+		return FALSE;
+
+	index_set(data, size, FALSE);
+
+	return TRUE;
+}
+
+gboolean vconf_operator_index_loaded(void)
+{
+	return index_addr != NULL;
+}
+
+void vconf_operator_index_close(void)
+{
+	if (index_mapped)
+		munmap(index_addr, index_size);
+	else
+		g_free(index_addr);
+
+	index_addr = NULL;
+	index_size = 0;
+	index_mapped = FALSE;
+	index_count = 0;
+	index_entries = NULL;
+	index_strings = NULL;
+}
+
+const char *vconf_operator_index_find(const char *mcc, const char *mnc, const char **country)
+{
+	guint32 key = vconf_operator_key(mcc, mnc);
+	guint32 lo = 0, hi = index_count, mid;
+
+	if (!index_entries || key == VCONF_OPERATOR_KEY_INVALID)
+		return NULL;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (index_entries[mid].key < key)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if (lo == index_count || index_entries[lo].key != key)
+		return NULL;
+
+	if (country)
+		*country = index_strings + index_entries[lo].country;
+
+	return index_strings + index_entries[lo].name;
+}
@@ -0,0 +1,198 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * tel-vconf-provision: create the package's vconf keys in one process
+ *
+ * Replaces the per-key vconftool calls of the install scripts. Every
+ * missing key, and every VCONF_SCHEMA_FORCE key, is written with its
+ * schema default in a single vconf_set(). With --check nothing is written
+ * and the exit status tells whether any key is missing.
+ *
+ * VCONF_SCHEMA_INSTALL memory keys must also be recreated at boot. vconf
+ * restores them from the image vconftool -i keeps under
+ * VCONF_MEMORY_INIT_DIR, one file per key in vconf's file backend format
+ * (int type, then the value); the vconf API cannot write there, so the
+ * image files are written here directly and the live keys go into the
+ * same keylist as the others.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+
+#include <glib.h>
+#include <vconf.h>
+
+#include "vconf-schema.h"
+
+#define VCONF_MEMORY_PREFIX "memory/"
+#define VCONF_MEMORY_INIT_DIR "/opt/var/kdb/memory_init"
+
+static const struct vconf_schema_entry vconf_schema[] = {
+	VCONF_SCHEMA(VCONF_SCHEMA_ENTRY)
+};
+
+static gboolean key_exists(const struct vconf_schema_entry *e)
+{
+	int value;
+	char *str;
+
+	switch (e->type) {
+		case VCONF_TYPE_INT:
+			return vconf_get_int(e->name, &value) == 0;
+
+		case VCONF_TYPE_BOOL:
+			return vconf_get_bool(e->name, &value) == 0;
+
+		case VCONF_TYPE_STRING:
+			str = vconf_get_str(e->name);
+			free(str);
+			return str != NULL;
+
+		default:
+			return FALSE;
+	}
+}
+
+static int keylist_add(keylist_t *kl, const char *name, const struct vconf_schema_entry *e)
+{
+	switch (e->type) {
+		case VCONF_TYPE_INT:
+			return vconf_keylist_add_int(kl, name, e->ival);
+
+		case VCONF_TYPE_BOOL:
+			return vconf_keylist_add_bool(kl, name, e->ival);
+
+		case VCONF_TYPE_STRING:
+			return vconf_keylist_add_str(kl, name, e->sval);
+
+		default:
+			return -1;
+	}
+}
+
+/* what vconftool set -i stores for the key */
+static gboolean memory_init_write(const struct vconf_schema_entry *e)
+{
+	GError *error = NULL;
+	gchar *path, *dir, *image;
+	gint type = e->type;
+	gint value;
+	gsize len;
+	gboolean ret = FALSE;
+
+	switch (e->type) {
+		case VCONF_TYPE_INT:
+		case VCONF_TYPE_BOOL:
+			value = e->type == VCONF_TYPE_BOOL ? !!e->ival : e->ival;
+			len = sizeof(type) + sizeof(value);
+			image = g_malloc(len);
+			memcpy(image + sizeof(type), &value, sizeof(value));
+			break;
+
+		case VCONF_TYPE_STRING:
+			len = sizeof(type) + strlen(e->sval);
+			image = g_malloc(len);
+			memcpy(image + sizeof(type), e->sval, strlen(e->sval));
+			break;
+
+		default:
+			return FALSE;
+	}
+	memcpy(image, &type, sizeof(type));
+
+	path = g_build_filename(VCONF_MEMORY_INIT_DIR, e->name, NULL);
+	dir = g_path_get_dirname(path);
+
+	if (g_mkdir_with_parents(dir, 0755) != 0)
+		fprintf(stderr, "tel-vconf-provision: %s: %s\n", dir, strerror(errno));
+	else if (!g_file_set_contents(path, image, len, &error)) {
+		fprintf(stderr, "tel-vconf-provision: %s\n", error->message);
+		g_error_free(error);
+	}
+	else
+		ret = TRUE;
+
+	g_free(dir);
+	g_free(path);
+	g_free(image);
+
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	const struct vconf_schema_entry *e;
+	gboolean check = (argc > 1 && strcmp(argv[1], "--check") == 0);
+	keylist_t *kl;
+	gboolean exists;
+	unsigned int i;
+	int missing = 0;
+	int count = 0;
+	int images = 0;
+	int ret = 0;
+
+	kl = vconf_keylist_new();
+
+	for (i = 0; i < G_N_ELEMENTS(vconf_schema); i++) {
+		e = &vconf_schema[i];
+		exists = key_exists(e);
+
+		if (exists && !(e->flags & VCONF_SCHEMA_FORCE))
+			continue;
+
+		if (!exists) {
+			missing++;
+			if (check)
+				printf("missing: %s\n", e->name);
+		}
+
+		if (check)
+			continue;
+
+		if ((e->flags & VCONF_SCHEMA_INSTALL) && g_str_has_prefix(e->name, VCONF_MEMORY_PREFIX)) {
+			if (memory_init_write(e))
+				images++;
+			else
+				ret = 1;
+		}
+
+		if (keylist_add(kl, e->name, e) > 0)
+			count++;
+	}
+
+	if (check) {
+		ret = missing ? 1 : 0;
+	}
+	else if (count > 0 && vconf_set(kl) != 0) {
+		fprintf(stderr, "tel-vconf-provision: vconf_set() failed for %d keys\n", count);
+		ret = 1;
+	}
+	else {
+		printf("tel-vconf-provision: %d keys written, %d boot images, %d created\n",
+				count, images, missing);
+	}
+
+	vconf_keylist_free(kl);
+
+	return ret;
+}
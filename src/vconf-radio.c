@@ -0,0 +1,140 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include <glib.h>
+
+#include "vconf-radio.h"
+
+static struct vconf_radio_record *ring;
+static guint ring_mask;
+static guint64 ring_head;	/* total records written */
+
+static const char *field_names[VCONF_RADIO_FIELD_MAX] = {
+	[VCONF_RADIO_RSSI] = "rssi",
+	[VCONF_RADIO_CELLID] = "cellid",
+	[VCONF_RADIO_LAC] = "lac",
+	[VCONF_RADIO_SVCTYPE] = "svctype",
+	[VCONF_RADIO_PSTYPE] = "pstype",
+};
+
+static gboolean last_valid[VCONF_RADIO_FIELD_MAX];
+static gint32 last_value[VCONF_RADIO_FIELD_MAX];
+
+gboolean vconf_radio_init(guint capacity)
+{
+	guint size = 1;
+
+	vconf_radio_free();
+
+	if (!capacity)
+		return FALSE;
+
+	while (size < capacity)
+		size <<= 1;
+
+	ring = g_new0(struct vconf_radio_record, size);
+	ring_mask = size - 1;
+
+	return TRUE;
+}
+
+void vconf_radio_free(void)
+{
+	g_free(ring);
+	ring = NULL;
+	ring_mask = 0;
+	ring_head = 0;
+	memset(last_valid, 0, sizeof(last_valid));
+}
+
+void vconf_radio_record(enum vconf_radio_field field, gint32 value)
+{
+	struct vconf_radio_record *r;
+
+	if (!ring || field >= VCONF_RADIO_FIELD_MAX)
+		return;
+
+	if (last_valid[field] && last_value[field] == value)
+		return;
+
+	last_valid[field] = TRUE;
+	last_value[field] = value;
+
+	r = &ring[ring_head & ring_mask];
+	r->time = g_get_monotonic_time();
+	r->field = field;
+	r->value = value;
+	ring_head++;
+}
+
+guint vconf_radio_snapshot(gint64 from, gint64 to, struct vconf_radio_record *out, guint max)
+{
+	guint64 first, lo, hi, mid;
+	guint n = 0;
+
+	if (!ring || !out || !max || !ring_head)
+		return 0;
+
+	first = ring_head > (guint64)ring_mask + 1 ? ring_head - ring_mask - 1 : 0;
+
+	/* records are in time order, so binary search for the first >= from */
+	lo = first;
+	hi = ring_head;
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (ring[mid & ring_mask].time < from)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	for (; lo < ring_head && n < max; lo++) {
+		if (to > 0 && ring[lo & ring_mask].time >= to)
+			break;
+		out[n++] = ring[lo & ring_mask];
+	}
+
+	return n;
+}
+
+gchar *vconf_radio_export(void)
+{
+	GString *out;
+	guint64 i, first = 0;
+
+	out = g_string_new(NULL);
+	g_string_append_printf(out, "{\"now\":%" G_GINT64_FORMAT ",\"records\":[", g_get_monotonic_time());
+
+	if (ring)
+		first = ring_head > (guint64)ring_mask + 1 ? ring_head - ring_mask - 1 : 0;
+
+	for (i = first; ring && i < ring_head; i++) {
+		struct vconf_radio_record *r = &ring[i & ring_mask];
+
+		g_string_append_printf(out, "%s{\"time\":%" G_GINT64_FORMAT ",\"field\":\"%s\",\"value\":%d}",
+				i == first ? "" : ",", r->time, field_names[r->field], r->value);
+	}
+
+	g_string_append(out, "]}");
+
+	return g_string_free(out, FALSE);
+}
@@ -0,0 +1,198 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "vconf-shm.h"
+
+struct vconf_shm {
+	const struct vconf_shm_header *hdr;
+	size_t size;
+};
+
+static uint32_t shm_read_begin(const struct vconf_shm_header *hdr)
+{
+	uint32_t seq;
+
+	do {
+		seq = __atomic_load_n(&hdr->seq, __ATOMIC_ACQUIRE);
+	} while (seq & 1);
+
+	return seq;
+}
+
+static int shm_read_retry(const struct vconf_shm_header *hdr, uint32_t seq)
+{
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	return __atomic_load_n(&hdr->seq, __ATOMIC_RELAXED) != seq;
+}
+
+VconfShm *vconf_shm_open(void)
+{
+	VconfShm *shm;
+	struct stat st;
+	void *addr;
+	int fd;
+
+	fd = shm_open(VCONF_SHM_NAME, O_RDONLY, 0);
+	if (fd < 0)
+		return NULL;
+
+	if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(struct vconf_shm_header)) {
+		close(fd);
+		return NULL;
+	}
+
+	addr = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED)
+		return NULL;
+
+	shm = calloc(1, sizeof(*shm));
+	if (!shm) {
+		munmap(addr, st.st_size);
+		return NULL;
+	}
+
+	shm->hdr = addr;
+	shm->size = st.st_size;
+
+	if (shm->hdr->magic != VCONF_SHM_MAGIC || shm->hdr->version != VCONF_SHM_VERSION
+			|| sizeof(struct vconf_shm_header)
+				+ (size_t)shm->hdr->count * sizeof(struct vconf_shm_entry) > shm->size) {
+		vconf_shm_close(shm);
+		return NULL;
+	}
+
+	return shm;
+}
+
+int vconf_shm_stale(VconfShm *shm)
+{
+	if (!shm)
+		return 1;
+
+	return __atomic_load_n(&shm->hdr->magic, __ATOMIC_ACQUIRE) != VCONF_SHM_MAGIC;
+}
+
+void vconf_shm_close(VconfShm *shm)
+{
+	if (!shm)
+		return;
+
+	munmap((void *)shm->hdr, shm->size);
+	free(shm);
+}
+
+int vconf_shm_find(VconfShm *shm, const char *name)
+{
+	uint32_t i;
+
+	if (!shm || !name)
+		return -1;
+
+	/* names are written once before the region is published */
+	for (i = 0; i < shm->hdr->count; i++) {
+		if (strncmp(shm->hdr->entries[i].name, name, VCONF_SHM_NAME_MAX) == 0)
+			return i;
+	}
+
+	return -1;
+}
+
+int vconf_shm_get_int(VconfShm *shm, int slot, int *value)
+{
+	const struct vconf_shm_entry *e;
+	uint32_t seq;
+	uint32_t valid;
+	int32_t v;
+
+	if (!shm || !value || slot < 0 || (uint32_t)slot >= shm->hdr->count)
+		return -1;
+
+	e = &shm->hdr->entries[slot];
+	do {
+		seq = shm_read_begin(shm->hdr);
+		valid = e->valid;
+		v = e->ival;
+	} while (shm_read_retry(shm->hdr, seq));
+
+	if (!valid || e->type == VCONF_SHM_TYPE_STRING || vconf_shm_stale(shm))
+		return -1;
+
+	*value = v;
+	return 0;
+}
+
+int vconf_shm_get_str(VconfShm *shm, int slot, char *buf, size_t len)
+{
+	const struct vconf_shm_entry *e;
+	char tmp[VCONF_SHM_STR_MAX];
+	uint32_t seq;
+	uint32_t valid;
+
+	if (!shm || !buf || !len || slot < 0 || (uint32_t)slot >= shm->hdr->count)
+		return -1;
+
+	e = &shm->hdr->entries[slot];
+	if (e->type != VCONF_SHM_TYPE_STRING)
+		return -1;
+
+	do {
+		seq = shm_read_begin(shm->hdr);
+		valid = e->valid;
+		memcpy(tmp, e->sval, sizeof(tmp));
+	} while (shm_read_retry(shm->hdr, seq));
+
+	if (!valid || vconf_shm_stale(shm))
+		return -1;
+
+	tmp[sizeof(tmp) - 1] = '\0';
+	if (strlen(tmp) >= len)
+		return -1;
+
+	strcpy(buf, tmp);
+	return 0;
+}
+
+int vconf_shm_snapshot(VconfShm *shm, struct vconf_shm_entry *out, int count)
+{
+	uint32_t seq;
+	int n;
+
+	if (!shm || !out || count <= 0)
+		return 0;
+
+	n = count < (int)shm->hdr->count ? count : (int)shm->hdr->count;
+	do {
+		seq = shm_read_begin(shm->hdr);
+		memcpy(out, shm->hdr->entries, n * sizeof(*out));
+	} while (shm_read_retry(shm->hdr, seq));
+
+	if (vconf_shm_stale(shm))
+		return 0;
+
+	return n;
+}
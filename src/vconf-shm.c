@@ -0,0 +1,210 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <glib.h>
+
+#include <tcore.h>
+
+#include "vconf-shm-writer.h"
+
+static struct vconf_shm_header *shm_hdr;
+static size_t shm_size;
+
+static void shm_write_begin(void)
+{
+	__atomic_store_n(&shm_hdr->seq, shm_hdr->seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static void shm_write_end(void)
+{
+	__atomic_store_n(&shm_hdr->seq, shm_hdr->seq + 1, __ATOMIC_RELEASE);
+}
+
+/*
+ * Tells readers still mapping the region of an earlier run that it is
+ * dead. The object is never truncated in place, since a reader touching
+ * a page beyond the new size would get SIGBUS.
+ */
+static void shm_retire(void)
+{
+	struct vconf_shm_header *hdr;
+	struct stat st;
+	int fd;
+
+	fd = shm_open(VCONF_SHM_NAME, O_RDWR, 0);
+	if (fd < 0)
+		return;
+
+	if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(*hdr)) {
+		hdr = mmap(NULL, sizeof(*hdr), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		if (hdr != MAP_FAILED) {
+			__atomic_store_n(&hdr->magic, 0, __ATOMIC_RELEASE);
+			munmap(hdr, sizeof(*hdr));
+		}
+	}
+	close(fd);
+
+	shm_unlink(VCONF_SHM_NAME);
+}
+
+gboolean vconf_shm_writer_open(unsigned int count)
+{
+	void *addr;
+	int fd;
+
+	if (shm_hdr)
+		return TRUE;
+
+	shm_size = sizeof(struct vconf_shm_header) + count * sizeof(struct vconf_shm_entry);
+
+	shm_retire();
+
+	fd = shm_open(VCONF_SHM_NAME, O_CREAT | O_EXCL | O_RDWR, VCONF_SHM_MODE);
+	if (fd < 0) {
+		err("shm_open(%s) failed", VCONF_SHM_NAME);
+		return FALSE;
+	}
+
+	if (ftruncate(fd, shm_size) < 0) {
+		err("ftruncate(%s) failed", VCONF_SHM_NAME);
+		close(fd);
+		shm_unlink(VCONF_SHM_NAME);
+		return FALSE;
+	}
+
+	addr = mmap(NULL, shm_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED) {
+		err("mmap(%s) failed", VCONF_SHM_NAME);
+		shm_unlink(VCONF_SHM_NAME);
+		return FALSE;
+	}
+
+	shm_hdr = addr;
+	shm_hdr->count = count;
+	shm_hdr->version = VCONF_SHM_VERSION;
+
+	return TRUE;
+}
+
+void vconf_shm_writer_close(void)
+{
+	if (!shm_hdr)
+		return;
+
+	__atomic_store_n(&shm_hdr->magic, 0, __ATOMIC_RELEASE);
+	munmap(shm_hdr, shm_size);
+	shm_unlink(VCONF_SHM_NAME);
+	shm_hdr = NULL;
+}
+
+void vconf_shm_writer_add(unsigned int slot, const char *name, enum vconf_shm_type type)
+{
+	if (!shm_hdr || slot >= shm_hdr->count)
+		return;
+
+	g_strlcpy(shm_hdr->entries[slot].name, name, VCONF_SHM_NAME_MAX);
+	shm_hdr->entries[slot].type = type;
+}
+
+/* readers accept the region once the magic is set */
+void vconf_shm_writer_publish(void)
+{
+	if (!shm_hdr)
+		return;
+
+	__atomic_store_n(&shm_hdr->magic, VCONF_SHM_MAGIC, __ATOMIC_RELEASE);
+}
+
+void vconf_shm_writer_set_int(unsigned int slot, int value)
+{
+	struct vconf_shm_entry *e;
+
+	if (!shm_hdr || slot >= shm_hdr->count)
+		return;
+
+	e = &shm_hdr->entries[slot];
+	if (e->valid && e->ival == value)
+		return;
+
+	shm_write_begin();
+	e->ival = value;
+	e->valid = 1;
+	shm_write_end();
+}
+
+void vconf_shm_writer_set_str(unsigned int slot, const char *value)
+{
+	struct vconf_shm_entry *e;
+
+	if (!shm_hdr || slot >= shm_hdr->count || !value)
+		return;
+
+	/* a cut-off value would be wrong; readers fall back to vconf */
+	if (strlen(value) >= VCONF_SHM_STR_MAX) {
+		vconf_shm_writer_invalidate(slot);
+		return;
+	}
+
+	e = &shm_hdr->entries[slot];
+	if (e->valid && strcmp(e->sval, value) == 0)
+		return;
+
+	shm_write_begin();
+	g_strlcpy(e->sval, value, VCONF_SHM_STR_MAX);
+	e->valid = 1;
+	shm_write_end();
+}
+
+void vconf_shm_writer_invalidate(unsigned int slot)
+{
+	if (!shm_hdr || slot >= shm_hdr->count || !shm_hdr->entries[slot].valid)
+		return;
+
+	shm_write_begin();
+	shm_hdr->entries[slot].valid = 0;
+	shm_write_end();
+}
+
+/* the plugin is the only writer, so its own reads need no retry loop */
+gboolean vconf_shm_writer_get_int(unsigned int slot, int *value)
+{
+	if (!shm_hdr || slot >= shm_hdr->count || !shm_hdr->entries[slot].valid)
+		return FALSE;
+
+	*value = shm_hdr->entries[slot].ival;
+	return TRUE;
+}
+
+char *vconf_shm_writer_get_str(unsigned int slot)
+{
+	if (!shm_hdr || slot >= shm_hdr->count || !shm_hdr->entries[slot].valid)
+		return NULL;
+
+	return strndup(shm_hdr->entries[slot].sval, VCONF_SHM_STR_MAX);
+}
@@ -0,0 +1,312 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unistd.h>
+
+#include <glib.h>
+
+#include "vconf-trace.h"
+
+struct trace_ring {
+	struct vconf_trace_event *events;
+	volatile gint head;	/* events recorded, only advanced by the owner */
+	guint tid;
+};
+
+struct trace_copy {
+	struct vconf_trace_event event;
+	guint tid;
+};
+
+/* first and last event of a hook, the source of its flow */
+struct trace_span {
+	gint64 begin;
+	gint64 end;
+	guint tid;
+};
+
+static const char *trace_kind_names[VCONF_TRACE_KIND_MAX] = {
+	"hook", "set", "callback", "reconcile", "link",
+};
+
+static guint trace_size;	/* events per ring, 0: disabled */
+
+static GPrivate trace_local = G_PRIVATE_INIT(NULL);
+static GMutex trace_lock;	/* trace_rings, trace_threads */
+static GSList *trace_rings;
+static guint trace_threads;
+
+static guint32 trace_next_flow;
+static guint32 trace_cause_flow;
+
+gboolean vconf_trace_init(guint capacity)
+{
+	guint size = 1;
+
+	vconf_trace_free();
+
+	if (!capacity)
+		return FALSE;
+
+	while (size < capacity)
+		size <<= 1;
+
+	trace_size = size;
+	return TRUE;
+}
+
+static void trace_ring_free(gpointer data)
+{
+	struct trace_ring *ring = data;
+
+	g_free(ring->events);
+	g_free(ring);
+}
+
+void vconf_trace_free(void)
+{
+	trace_size = 0;
+
+	g_mutex_lock(&trace_lock);
+	g_slist_free_full(trace_rings, trace_ring_free);
+	trace_rings = NULL;
+	trace_threads = 0;
+	g_mutex_unlock(&trace_lock);
+
+	g_private_set(&trace_local, NULL);
+	trace_next_flow = 0;
+	trace_cause_flow = 0;
+}
+
+gboolean vconf_trace_enabled(void)
+{
+	return trace_size != 0;
+}
+
+guint32 vconf_trace_flow_new(void)
+{
+	if (!trace_size)
+		return 0;
+
+	if (++trace_next_flow == 0)
+		trace_next_flow = 1;
+
+	return trace_next_flow;
+}
+
+guint32 vconf_trace_cause(void)
+{
+	return trace_cause_flow;
+}
+
+void vconf_trace_set_cause(guint32 flow)
+{
+	trace_cause_flow = flow;
+}
+
+static struct trace_ring *trace_ring_get(void)
+{
+	struct trace_ring *ring = g_private_get(&trace_local);
+
+	if (ring)
+		return ring;
+
+	ring = g_new0(struct trace_ring, 1);
+	ring->events = g_new0(struct vconf_trace_event, trace_size);
+
+	g_mutex_lock(&trace_lock);
+	ring->tid = ++trace_threads;
+	trace_rings = g_slist_append(trace_rings, ring);
+	g_mutex_unlock(&trace_lock);
+
+	g_private_set(&trace_local, ring);
+	return ring;
+}
+
+static void trace_record(enum vconf_trace_kind kind, guint8 phase, const char *name,
+		guint32 arg, guint32 size, guint32 flow)
+{
+	struct trace_ring *ring;
+	struct vconf_trace_event *e;
+	guint head;
+
+	if (!trace_size)
+		return;
+
+	ring = trace_ring_get();
+	head = (guint)g_atomic_int_get(&ring->head);
+
+	e = &ring->events[head & (trace_size - 1)];
+	e->time = g_get_monotonic_time();
+	e->name = name;
+	e->arg = arg;
+	e->size = size;
+	e->flow = flow;
+	e->kind = kind;
+	e->phase = phase;
+
+	/* publishes the event to the exporter */
+	g_atomic_int_set(&ring->head, (gint)(head + 1));
+}
+
+void vconf_trace_begin(enum vconf_trace_kind kind, const char *name, guint32 arg, guint32 size, guint32 flow)
+{
+	trace_record(kind, 'B', name, arg, size, flow);
+}
+
+void vconf_trace_end(enum vconf_trace_kind kind, const char *name, guint32 arg, guint32 size, guint32 flow)
+{
+	trace_record(kind, 'E', name, arg, size, flow);
+}
+
+void vconf_trace_link(guint32 flow)
+{
+	if (flow)
+		trace_record(VCONF_TRACE_LINK, 'L', NULL, 0, 0, flow);
+}
+
+/*
+ * Copies the events of a ring while its owner may keep recording, and
+ * drops those overwritten meanwhile, including the slot being written.
+ */
+static void trace_ring_copy(struct trace_ring *ring, GArray *out)
+{
+	struct trace_copy c;
+	guint head, first, valid, start, i;
+
+	head = (guint)g_atomic_int_get(&ring->head);
+	first = head > trace_size ? head - trace_size : 0;
+	start = out->len;
+
+	for (i = first; i < head; i++) {
+		c.event = ring->events[i & (trace_size - 1)];
+		c.tid = ring->tid;
+		g_array_append_val(out, c);
+	}
+
+	head = (guint)g_atomic_int_get(&ring->head);
+	valid = head + 1 > trace_size ? head + 1 - trace_size : 0;
+	if (valid > first)
+		g_array_remove_range(out, start, MIN(valid - first, out->len - start));
+}
+
+static void trace_append(GString *out, gboolean *first, const struct trace_copy *c)
+{
+	const struct vconf_trace_event *e = &c->event;
+
+	g_string_append_printf(out, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%lld,\"pid\":%d,\"tid\":%u",
+			*first ? "" : ",", e->name ? e->name : "", trace_kind_names[e->kind], e->phase,
+			(long long)e->time, (int)getpid(), c->tid);
+	*first = FALSE;
+
+	if (e->phase != 'B') {
+		g_string_append_c(out, '}');
+		return;
+	}
+
+	if (e->kind == VCONF_TRACE_HOOK)
+		g_string_append_printf(out, ",\"args\":{\"command\":\"0x%x\",\"size\":%u,\"flow\":%u}}",
+				e->arg, e->size, e->flow);
+	else
+		g_string_append_printf(out, ",\"args\":{\"keys\":%u,\"size\":%u,\"flow\":%u}}",
+				e->arg, e->size, e->flow);
+}
+
+/*
+ * Arrow from the start of the hook that opened the flow to the slice
+ * enclosing c. Work nested in the hook's own slice needs none.
+ */
+static void trace_append_flow(GString *out, gboolean *first, GHashTable *spans,
+		const struct trace_copy *c, guint *arrows)
+{
+	const struct vconf_trace_event *e = &c->event;
+	struct trace_span *span = g_hash_table_lookup(spans, GUINT_TO_POINTER(e->flow));
+
+	if (!span)
+		return;
+
+	if (span->tid == c->tid && e->time >= span->begin && e->time <= span->end)
+		return;
+
+	(*arrows)++;
+	g_string_append_printf(out, "%s{\"name\":\"cause\",\"cat\":\"flow\",\"ph\":\"s\",\"id\":%u,\"ts\":%lld,\"pid\":%d,\"tid\":%u}"
+			",{\"name\":\"cause\",\"cat\":\"flow\",\"ph\":\"f\",\"bp\":\"e\",\"id\":%u,\"ts\":%lld,\"pid\":%d,\"tid\":%u}",
+			*first ? "" : ",", *arrows, (long long)span->begin, (int)getpid(), span->tid,
+			*arrows, (long long)e->time, (int)getpid(), c->tid);
+	*first = FALSE;
+}
+
+gchar *vconf_trace_export(void)
+{
+	GArray *events;
+	GHashTable *spans;
+	GString *out;
+	GSList *l;
+	struct trace_copy *c;
+	struct trace_span *span;
+	gboolean first = TRUE;
+	guint arrows = 0;
+	guint i;
+
+	events = g_array_new(FALSE, FALSE, sizeof(struct trace_copy));
+	if (trace_size) {
+		g_mutex_lock(&trace_lock);
+		for (l = trace_rings; l; l = l->next)
+			trace_ring_copy(l->data, events);
+		g_mutex_unlock(&trace_lock);
+	}
+
+	spans = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+	for (i = 0; i < events->len; i++) {
+		c = &g_array_index(events, struct trace_copy, i);
+		if (c->event.kind != VCONF_TRACE_HOOK || !c->event.flow)
+			continue;
+
+		span = g_hash_table_lookup(spans, GUINT_TO_POINTER(c->event.flow));
+		if (!span) {
+			span = g_new0(struct trace_span, 1);
+			span->begin = c->event.time;
+			span->end = G_MAXINT64;
+			span->tid = c->tid;
+			g_hash_table_insert(spans, GUINT_TO_POINTER(c->event.flow), span);
+		}
+
+		if (c->event.phase == 'E')
+			span->end = c->event.time;
+	}
+
+	out = g_string_new("{\"traceEvents\":[");
+	for (i = 0; i < events->len; i++) {
+		c = &g_array_index(events, struct trace_copy, i);
+
+		if (c->event.phase != 'L')
+			trace_append(out, &first, c);
+
+		if (c->event.flow && (c->event.phase == 'L'
+					|| (c->event.phase == 'B' && c->event.kind != VCONF_TRACE_HOOK)))
+			trace_append_flow(out, &first, spans, c, &arrows);
+	}
+	g_string_append(out, "],\"displayTimeUnit\":\"ms\"}");
+
+	g_hash_table_destroy(spans);
+	g_array_free(events, TRUE);
+
+	return g_string_free(out, FALSE);
+}
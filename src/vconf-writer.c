@@ -0,0 +1,413 @@
+/*
+ * tel-plugin-vconf
+ *
+ * Copyright (c) 2012 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Ja-young Gu <jygu@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+#include <vconf.h>
+
+#include <tcore.h>
+
+#include "vconf-writer.h"
+#include "vconf-trace.h"
+
+struct vconf_write {
+	const char *name;	/* NULL for a keylist */
+	int type;
+	int ival;
+	char *sval;
+	keylist_t *kl;
+	guint32 flow;	/* trace flow of the latest queued value */
+	GList link;	/* in writer_queue */
+};
+
+static GThread *writer_thread;
+static GMutex writer_lock;
+static GCond writer_cond;
+static GQueue writer_queue;
+static guint writer_max;
+static guint writer_busy;
+static gboolean writer_quit;
+
+/* keys of failed writes, reported on the main loop */
+static VconfWriterFailed writer_failed;
+static GPtrArray *writer_failed_names;
+static guint writer_failed_idle;
+
+/* name -> queued single write that may still be coalesced */
+static GHashTable *writer_latest;
+/* name -> number of queued or in-progress writes */
+static GHashTable *writer_pending;
+
+static void pending_add(const char *name, int delta)
+{
+	int n = GPOINTER_TO_INT(g_hash_table_lookup(writer_pending, name)) + delta;
+
+	if (n > 0)
+		g_hash_table_insert(writer_pending, (gpointer)name, GINT_TO_POINTER(n));
+	else
+		g_hash_table_remove(writer_pending, name);
+}
+
+static void keylist_pending_add(keylist_t *kl, int delta)
+{
+	keynode_t *node;
+
+	vconf_keylist_rewind(kl);
+	while ((node = vconf_keylist_nextnode(kl)) != NULL)
+		pending_add(g_intern_string(vconf_keynode_get_name(node)), delta);
+}
+
+static void write_free(struct vconf_write *w)
+{
+	g_free(w->sval);
+	if (w->kl)
+		vconf_keylist_free(w->kl);
+	g_free(w);
+}
+
+static gboolean writer_report_failed(gpointer user_data)
+{
+	GPtrArray *names;
+	guint i;
+
+	g_mutex_lock(&writer_lock);
+	names = writer_failed_names;
+	writer_failed_names = g_ptr_array_new();
+	writer_failed_idle = 0;
+	g_mutex_unlock(&writer_lock);
+
+	for (i = 0; i < names->len; i++)
+		writer_failed(g_ptr_array_index(names, i));
+	g_ptr_array_free(names, TRUE);
+
+	return FALSE;
+}
+
+/* called with writer_lock held */
+static void write_failed(struct vconf_write *w)
+{
+	keynode_t *node;
+
+	if (!writer_failed)
+		return;
+
+	if (w->kl) {
+		vconf_keylist_rewind(w->kl);
+		while ((node = vconf_keylist_nextnode(w->kl)) != NULL)
+			g_ptr_array_add(writer_failed_names, (gpointer)g_intern_string(vconf_keynode_get_name(node)));
+	}
+	else
+		g_ptr_array_add(writer_failed_names, (gpointer)w->name);
+
+	if (!writer_failed_idle)
+		writer_failed_idle = g_idle_add(writer_report_failed, NULL);
+}
+
+static int write_run(struct vconf_write *w)
+{
+	const char *name = w->name ? w->name : "keylist";
+	guint32 size = 0;
+	int ret = 0;
+
+	if (w->sval)
+		size = strlen(w->sval) + 1;
+	else if (w->name)
+		size = sizeof(int);
+
+	vconf_trace_begin(VCONF_TRACE_SET, name, w->name ? 1 : 0, size, w->flow);
+
+	if (w->kl)
+		ret = vconf_set(w->kl);
+	else if (w->type == VCONF_TYPE_INT)
+		ret = vconf_set_int(w->name, w->ival);
+	else if (w->type == VCONF_TYPE_BOOL)
+		ret = vconf_set_bool(w->name, w->ival);
+	else if (w->type == VCONF_TYPE_STRING)
+		ret = vconf_set_str(w->name, w->sval);
+
+	vconf_trace_end(VCONF_TRACE_SET, name, w->name ? 1 : 0, size, w->flow);
+
+	if (ret != 0)
+		err("write-behind failed for %s", w->name ? w->name : "keylist");
+
+	return ret;
+}
+
+static gpointer writer_main(gpointer data)
+{
+	struct vconf_write *w;
+	GList *link;
+	int ret;
+
+	g_mutex_lock(&writer_lock);
+	while (TRUE) {
+		while (g_queue_is_empty(&writer_queue) && !writer_quit)
+			g_cond_wait(&writer_cond, &writer_lock);
+
+		/* the link is part of the write */
+		link = g_queue_pop_head_link(&writer_queue);
+		if (!link)
+			break;
+		w = link->data;
+
+		if (w->name && g_hash_table_lookup(writer_latest, w->name) == w)
+			g_hash_table_remove(writer_latest, w->name);
+
+		writer_busy++;
+		g_cond_broadcast(&writer_cond);
+		g_mutex_unlock(&writer_lock);
+
+		ret = write_run(w);
+
+		g_mutex_lock(&writer_lock);
+		if (ret != 0)
+			write_failed(w);
+		if (w->kl)
+			keylist_pending_add(w->kl, -1);
+		else
+			pending_add(w->name, -1);
+		writer_busy--;
+		g_cond_broadcast(&writer_cond);
+		g_mutex_unlock(&writer_lock);
+
+		write_free(w);
+
+		g_mutex_lock(&writer_lock);
+	}
+	g_mutex_unlock(&writer_lock);
+
+	return NULL;
+}
+
+gboolean vconf_writer_start(guint max_queue, VconfWriterFailed failed)
+{
+	if (writer_thread)
+		return TRUE;
+
+	g_mutex_init(&writer_lock);
+	g_cond_init(&writer_cond);
+	g_queue_init(&writer_queue);
+	writer_latest = g_hash_table_new(g_str_hash, g_str_equal);
+	writer_pending = g_hash_table_new(g_str_hash, g_str_equal);
+	writer_failed_names = g_ptr_array_new();
+	writer_failed = failed;
+	writer_max = MAX(max_queue, 1);
+	writer_quit = FALSE;
+
+	writer_thread = g_thread_try_new("vconf-writer", writer_main, NULL, NULL);
+	if (!writer_thread) {
+		err("failed to start the write-behind thread");
+		g_hash_table_destroy(writer_latest);
+		g_hash_table_destroy(writer_pending);
+		g_ptr_array_free(writer_failed_names, TRUE);
+		writer_failed_names = NULL;
+		g_cond_clear(&writer_cond);
+		g_mutex_clear(&writer_lock);
+		return FALSE;
+	}
+
+	dbg("write-behind started (queue %u)", writer_max);
+	return TRUE;
+}
+
+void vconf_writer_stop(void)
+{
+	if (!writer_thread)
+		return;
+
+	g_mutex_lock(&writer_lock);
+	writer_quit = TRUE;
+	g_cond_broadcast(&writer_cond);
+	g_mutex_unlock(&writer_lock);
+
+	/* the thread drains the queue before it exits */
+	g_thread_join(writer_thread);
+	writer_thread = NULL;
+
+	/* failures of the drained writes are reported right here */
+	if (writer_failed_idle) {
+		g_source_remove(writer_failed_idle);
+		writer_report_failed(NULL);
+	}
+	g_ptr_array_free(writer_failed_names, TRUE);
+	writer_failed_names = NULL;
+	writer_failed = NULL;
+
+	g_hash_table_destroy(writer_latest);
+	g_hash_table_destroy(writer_pending);
+	writer_latest = writer_pending = NULL;
+	g_cond_clear(&writer_cond);
+	g_mutex_clear(&writer_lock);
+}
+
+gboolean vconf_writer_running(void)
+{
+	return writer_thread != NULL;
+}
+
+static int writer_enqueue(struct vconf_write *w)
+{
+	struct vconf_write *queued = NULL;
+
+	w->flow = vconf_trace_cause();
+	w->link.data = w;
+
+	g_mutex_lock(&writer_lock);
+
+	if (w->name)
+		queued = g_hash_table_lookup(writer_latest, w->name);
+
+	if (queued) {
+		/* the new value takes the tail, behind everything queued before it */
+		g_queue_unlink(&writer_queue, &queued->link);
+		pending_add(w->name, -1);
+	}
+	else if (g_queue_get_length(&writer_queue) >= writer_max) {
+		g_mutex_unlock(&writer_lock);
+		err("write-behind queue full, %s dropped", w->name ? w->name : "keylist");
+		return -1;
+	}
+
+	if (w->name) {
+		g_hash_table_insert(writer_latest, (gpointer)w->name, w);
+		pending_add(w->name, 1);
+	}
+	else {
+		/* nothing queued before a keylist may be overtaken by a later write */
+		g_hash_table_remove_all(writer_latest);
+		keylist_pending_add(w->kl, 1);
+	}
+
+	g_queue_push_tail_link(&writer_queue, &w->link);
+	g_cond_broadcast(&writer_cond);
+	g_mutex_unlock(&writer_lock);
+
+	if (queued)
+		write_free(queued);
+
+	return 0;
+}
+
+static int writer_enqueue_free(struct vconf_write *w)
+{
+	if (writer_enqueue(w) == 0)
+		return 0;
+
+	write_free(w);
+	return -1;
+}
+
+int vconf_writer_set_int(const char *name, int value)
+{
+	struct vconf_write *w = g_new0(struct vconf_write, 1);
+
+	w->name = name;
+	w->type = VCONF_TYPE_INT;
+	w->ival = value;
+	return writer_enqueue_free(w);
+}
+
+int vconf_writer_set_bool(const char *name, int value)
+{
+	struct vconf_write *w = g_new0(struct vconf_write, 1);
+
+	w->name = name;
+	w->type = VCONF_TYPE_BOOL;
+	w->ival = value;
+	return writer_enqueue_free(w);
+}
+
+int vconf_writer_set_str(const char *name, const char *value)
+{
+	struct vconf_write *w = g_new0(struct vconf_write, 1);
+
+	w->name = name;
+	w->type = VCONF_TYPE_STRING;
+	w->sval = g_strdup(value);
+	return writer_enqueue_free(w);
+}
+
+int vconf_writer_set_keylist(keylist_t *kl)
+{
+	struct vconf_write *w = g_new0(struct vconf_write, 1);
+
+	w->kl = kl;
+	if (writer_enqueue(w) == 0)
+		return 0;
+
+	/* a refused keylist stays with the caller */
+	g_free(w);
+	return -1;
+}
+
+void vconf_writer_flush(void)
+{
+	if (!writer_thread)
+		return;
+
+	g_mutex_lock(&writer_lock);
+	while (!g_queue_is_empty(&writer_queue) || writer_busy)
+		g_cond_wait(&writer_cond, &writer_lock);
+	g_mutex_unlock(&writer_lock);
+}
+
+gboolean vconf_writer_pending(const char *name)
+{
+	gboolean pending;
+
+	if (!writer_thread)
+		return FALSE;
+
+	g_mutex_lock(&writer_lock);
+	pending = g_hash_table_lookup(writer_pending, name) != NULL;
+	g_mutex_unlock(&writer_lock);
+
+	return pending;
+}
+
+gboolean vconf_writer_busy(void)
+{
+	gboolean busy;
+
+	if (!writer_thread)
+		return FALSE;
+
+	g_mutex_lock(&writer_lock);
+	busy = !g_queue_is_empty(&writer_queue) || writer_busy;
+	g_mutex_unlock(&writer_lock);
+
+	return busy;
+}
+
+gboolean vconf_writer_full(void)
+{
+	gboolean full;
+
+	if (!writer_thread)
+		return FALSE;
+
+	g_mutex_lock(&writer_lock);
+	full = g_queue_get_length(&writer_queue) >= writer_max;
+	g_mutex_unlock(&writer_lock);
+
+	return full;
+}